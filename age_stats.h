@@ -0,0 +1,235 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "flat_map.h"
+
+/*
+ * Running statistics over a table of ages, such as the "ages" map in
+ * demonstrateStl: count, sum, average, youngest, oldest and a histogram
+ * by age bucket.
+ *
+ * Scanning the table answers any of these in O(n), which adds up when
+ * the same numbers are asked for over and over (a dashboard polling them,
+ * say). AgeStatsMap wraps one of the maps from flat_map.h and updates its
+ * AgeStats on every insert, update and erase instead, so each query is
+ * O(1) and a change costs O(log d), d being the number of different ages.
+ * It is the same idea as a C# collection raising CollectionChanged to a
+ * view that keeps its own totals.
+ *
+ * For that to work every change has to go through the wrapper: find()
+ * only hands out const pointers, and a value is changed with assign(),
+ * setAge() or modify().
+ */
+
+// The statistics themselves, for any collection of ages
+class AgeStats {
+  public:
+      explicit AgeStats(int bucketWidth = 10) : bucketWidth_(bucketWidth) {
+          if (bucketWidth <= 0) {
+              throw std::invalid_argument("AgeStats: the bucket width must be positive");
+          }
+      }
+
+      void add(int age) {
+          count_++;
+          sum_ += age;
+          ages_[age]++;
+          buckets_[bucketOf(age)]++;
+      }
+
+      // `age` must have been added before
+      void remove(int age) {
+          count_--;
+          sum_ -= age;
+          decrement(ages_, age);
+          decrement(buckets_, bucketOf(age));
+      }
+
+      void replace(int oldAge, int newAge) {
+          if (oldAge != newAge) {
+              remove(oldAge);
+              add(newAge);
+          }
+      }
+
+      void clear() {
+          count_ = 0;
+          sum_ = 0;
+          ages_.clear();
+          buckets_.clear();
+      }
+
+      // ----- Queries, all O(1) -----
+      std::size_t count() const { return count_; }
+      long long sum() const { return sum_; }
+      double average() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0; }
+      bool empty() const { return count_ == 0; }
+      // Throw std::logic_error when there are no ages
+      int min() const { return nonEmpty().ages_.begin()->first; }
+      int max() const { return nonEmpty().ages_.rbegin()->first; }
+
+      // First age of each bucket -> how many ages fall in [first, first + width);
+      // empty buckets are left out
+      const std::map<int, std::size_t>& histogram() const { return buckets_; }
+      int bucketWidth() const { return bucketWidth_; }
+      int bucketOf(int age) const {
+          // Rounds down for negative ages too, so -1 lands in [-10, 0)
+          int bucket = age / bucketWidth_ * bucketWidth_;
+          return bucket > age ? bucket - bucketWidth_ : bucket;
+      }
+
+      bool operator==(const AgeStats& other) const = default;
+
+  private:
+      static void decrement(std::map<int, std::size_t>& counts, int key) {
+          auto it = counts.find(key);
+          if (it == counts.end()) {
+              throw std::logic_error("AgeStats: removing an age that was never added");
+          }
+          if (--it->second == 0) {
+              counts.erase(it);
+          }
+      }
+
+      const AgeStats& nonEmpty() const {
+          if (count_ == 0) {
+              throw std::logic_error("AgeStats: no ages");
+          }
+          return *this;
+      }
+
+      int bucketWidth_;
+      std::size_t count_ = 0;
+      long long sum_ = 0;
+      std::map<int, std::size_t> ages_;      // Age -> how many, for min() and max() after an erase
+      std::map<int, std::size_t> buckets_;
+};
+
+// The age of a map value: the value itself, or getAge() of a Person
+inline int ageOf(int age) { return age; }
+
+template <typename P>
+    requires requires(const P& person) { { person.getAge() } -> std::convertible_to<int>; }
+int ageOf(const P& person) {
+    return person.getAge();
+}
+
+// A StringMap (flat_map.h) of ages or of Person-like values, with the
+// AgeStats of everything in it
+template <typename V, typename Map = FlatHashMap<V>>
+    requires StringMap<Map> && std::same_as<typename Map::mapped_type, V>
+class AgeStatsMap {
+  public:
+      using mapped_type = V;
+
+      explicit AgeStatsMap(int bucketWidth = 10) : stats_(bucketWidth) {}
+
+      // Adds key -> value unless the key exists; true if it was added
+      bool insert(std::string_view key, V value) {
+          const int age = ageOf(value);
+          if (!map_.insert(key, std::move(value))) {
+              return false;
+          }
+          stats_.add(age);
+          return true;
+      }
+
+      // Adds or replaces (insert_or_assign); true if it was added
+      bool assign(std::string_view key, V value) {
+          if (V* existing = map_.find(key)) {
+              const int oldAge = ageOf(*existing);
+              *existing = std::move(value);
+              stats_.replace(oldAge, ageOf(*existing));
+              return false;
+          }
+          return insert(key, std::move(value));
+      }
+
+      // Changes the age of an existing entry (setAge() on a Person); false
+      // if there is no such key
+      bool setAge(std::string_view key, int age) {
+          V* value = map_.find(key);
+          if (!value) {
+              return false;
+          }
+          const int oldAge = ageOf(*value);
+          if constexpr (std::same_as<V, int>) {
+              *value = age;
+          } else {
+              value->setAge(age);
+          }
+          stats_.replace(oldAge, age);
+          return true;
+      }
+
+      // Calls edit(V&) on an existing entry and takes its age afterwards,
+      // also when edit throws; false if there is no such key
+      template <typename F>
+      bool modify(std::string_view key, F&& edit) {
+          V* value = map_.find(key);
+          if (!value) {
+              return false;
+          }
+          const int oldAge = ageOf(*value);
+          try {
+              edit(*value);
+          } catch (...) {
+              stats_.replace(oldAge, ageOf(*value));
+              throw;
+          }
+          stats_.replace(oldAge, ageOf(*value));
+          return true;
+      }
+
+      bool erase(std::string_view key) {
+          const V* value = map_.find(key);
+          if (!value) {
+              return false;
+          }
+          const int age = ageOf(*value);
+          map_.erase(key);
+          stats_.remove(age);
+          return true;
+      }
+
+      const V* find(std::string_view key) const { return map_.find(key); }
+      bool contains(std::string_view key) const { return map_.contains(key); }
+      std::size_t size() const { return map_.size(); }
+      void reserve(std::size_t count) { map_.reserve(count); }
+
+      void clear() {
+          map_.clear();
+          stats_.clear();
+      }
+
+      // visit(std::string_view key, const V& value), in ascending key order
+      template <typename F>
+      void forEachOrdered(F&& visit) {
+          map_.forEachOrdered([&visit](std::string_view key, const V& value) { visit(key, value); });
+      }
+
+      const AgeStats& stats() const { return stats_; }
+
+      // The statistics computed from scratch, O(n): equal to stats() unless
+      // something changed a value behind the wrapper's back
+      AgeStats rescan() {
+          AgeStats fresh(stats_.bucketWidth());
+          auto add = [&fresh](std::string_view, const V& value) { fresh.add(ageOf(value)); };
+          if constexpr (requires { map_.forEach(add); }) {
+              map_.forEach(add);   // No need to sort a hash table first
+          } else {
+              map_.forEachOrdered(add);
+          }
+          return fresh;
+      }
+
+  private:
+      Map map_;
+      AgeStats stats_;
+};
@@ -0,0 +1,95 @@
+#include "alloc_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocationCount{0};
+std::atomic<std::size_t> freeCount{0};
+std::atomic<std::size_t> allocatedBytes{0};
+
+// The same counts for the current thread only (no atomics needed)
+thread_local AllocationCounts threadCounts;
+
+void* countedAlloc(std::size_t size, std::size_t alignment = 0) noexcept {
+    if (size == 0) {
+        size = 1;  // operator new must return a unique pointer even for 0 bytes
+    }
+    void* p = nullptr;
+    if (alignment > alignof(std::max_align_t)) {
+        // aligned_alloc wants the size to be a multiple of the alignment
+        p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    } else {
+        p = std::malloc(size);
+    }
+    if (p != nullptr) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        threadCounts.allocations++;
+        threadCounts.bytes += size;
+    }
+    return p;
+}
+
+void* countedNew(std::size_t size, std::size_t alignment = 0) {
+    for (;;) {
+        if (void* p = countedAlloc(size, alignment)) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void countedFree(void* p) noexcept {
+    if (p != nullptr) {
+        freeCount.fetch_add(1, std::memory_order_relaxed);
+        threadCounts.frees++;
+        std::free(p);
+    }
+}
+
+}
+
+AllocationCounts allocationCounts() {
+    return {allocationCount.load(std::memory_order_relaxed),
+            freeCount.load(std::memory_order_relaxed),
+            allocatedBytes.load(std::memory_order_relaxed)};
+}
+
+AllocationCounts threadAllocationCounts() {
+    return threadCounts;
+}
+
+// ----- Replacements for every form of the global operator new/delete -----
+void* operator new(std::size_t size) { return countedNew(size); }
+void* operator new[](std::size_t size) { return countedNew(size); }
+void* operator new(std::size_t size, std::align_val_t al) { return countedNew(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return countedNew(size, static_cast<std::size_t>(al)); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return countedAlloc(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return countedAlloc(size, static_cast<std::size_t>(al));
+}
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { countedFree(p); }
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+/*
+ * Counts heap allocations by replacing the global operator new/delete.
+ *
+ * Only targets that link alloc_counter.cpp get the replacement (the benchmarks
+ * always, the tutorial binary when built with MYPROJECT_INSTRUMENTATION), so
+ * these functions are declared here but only defined where counting is on.
+ */
+struct AllocationCounts {
+    std::size_t allocations = 0;   // Calls to operator new (any form)
+    std::size_t frees = 0;         // Calls to operator delete with a non-null pointer
+    std::size_t bytes = 0;         // Bytes requested from operator new
+
+    AllocationCounts operator-(const AllocationCounts& earlier) const {
+        return {allocations - earlier.allocations, frees - earlier.frees, bytes - earlier.bytes};
+    }
+};
+
+// Totals for the whole process since startup
+AllocationCounts allocationCounts();
+
+// Totals for the calling thread since it started (frees are counted on the
+// thread that frees, which may not be the one that allocated)
+AllocationCounts threadAllocationCounts();
@@ -0,0 +1,467 @@
+#include "async_writer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#else
+#include <io.h>   // _write on Windows
+#endif
+
+#if __has_include(<linux/io_uring.h>) && __has_include(<sys/syscall.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#define MYPROJECT_HAS_IO_URING 1
+#else
+#define MYPROJECT_HAS_IO_URING 0
+#endif
+
+namespace async_io {
+
+Backend parseBackend(std::string_view name) {
+    if (name == "io_uring") {
+        return Backend::IoUring;
+    }
+    if (name == "thread") {
+        return Backend::Thread;
+    }
+    throw std::invalid_argument("unknown I/O backend '" + std::string(name) + "' (io_uring or thread)");
+}
+
+const char* backendName(Backend backend) {
+    switch (backend) {
+        case Backend::IoUring: return "io_uring";
+        case Backend::Thread: return "thread";
+    }
+    return "unknown";
+}
+
+// ----- Drivers -----
+
+// Runs one write() worth of a queued write at a time. The result is the
+// number of bytes written (possibly fewer than asked) or -errno.
+class EventLoop::Driver {
+  public:
+      struct Completion {
+          std::size_t slot;
+          long result;
+      };
+
+      virtual ~Driver() = default;
+      virtual Backend backend() const = 0;
+      virtual void submit(std::size_t slot, std::string_view data) = 0;
+      virtual Completion wait() = 0;
+};
+
+namespace {
+
+long writeSome(int fd, const char* data, std::size_t size) {
+#if __has_include(<unistd.h>)
+    return static_cast<long>(::write(fd, data, size));
+#else
+    return _write(fd, data, static_cast<unsigned>(std::min<std::size_t>(size, INT_MAX)));
+#endif
+}
+
+// A worker thread doing blocking write() calls
+class ThreadDriver : public EventLoop::Driver {
+  public:
+      explicit ThreadDriver(int fd) : fd_(fd), worker_([this] { workerLoop(); }) {}
+
+      ~ThreadDriver() override {
+          {
+              std::lock_guard<std::mutex> lock(mutex_);
+              stopping_ = true;
+          }
+          changed_.notify_all();
+          worker_.join();
+      }
+
+      Backend backend() const override { return Backend::Thread; }
+
+      void submit(std::size_t slot, std::string_view data) override {
+          {
+              std::lock_guard<std::mutex> lock(mutex_);
+              requests_.push_back({slot, data});
+          }
+          changed_.notify_all();
+      }
+
+      Completion wait() override {
+          std::unique_lock<std::mutex> lock(mutex_);
+          changed_.wait(lock, [this] { return !completions_.empty(); });
+          Completion completion = completions_.front();
+          completions_.pop_front();
+          return completion;
+      }
+
+  private:
+      struct Request {
+          std::size_t slot;
+          std::string_view data;
+      };
+
+      void workerLoop() {
+          std::unique_lock<std::mutex> lock(mutex_);
+          for (;;) {
+              changed_.wait(lock, [this] { return stopping_ || !requests_.empty(); });
+              if (requests_.empty()) {
+                  return;
+              }
+              Request request = requests_.front();
+              requests_.pop_front();
+              lock.unlock();
+              long result = writeAll(request.data);
+              lock.lock();
+              completions_.push_back({request.slot, result});
+              changed_.notify_all();
+          }
+      }
+
+      long writeAll(std::string_view data) {
+          std::size_t written = 0;
+          while (written < data.size()) {
+              long count = writeSome(fd_, data.data() + written, data.size() - written);
+              if (count < 0) {
+                  if (errno == EINTR) {
+                      continue;
+                  }
+                  return written > 0 ? static_cast<long>(written) : -errno;
+              }
+              written += static_cast<std::size_t>(count);
+          }
+          return static_cast<long>(written);
+      }
+
+      int fd_;
+      std::mutex mutex_;
+      std::condition_variable changed_;
+      std::deque<Request> requests_;
+      std::deque<Completion> completions_;
+      bool stopping_ = false;
+      std::thread worker_;      // Last: it starts running in the constructor
+};
+
+#if MYPROJECT_HAS_IO_URING
+
+// io_uring through the raw system calls: a submission ring the kernel
+// reads write requests from and a completion ring it puts the results in,
+// both shared with the kernel through mmap
+class IoUringDriver : public EventLoop::Driver {
+  public:
+      static constexpr unsigned kEntries = EventLoop::kMaxWrites;
+
+      // nullptr when io_uring is not available here
+      static std::unique_ptr<IoUringDriver> create(int fd) {
+          std::unique_ptr<IoUringDriver> driver(new IoUringDriver(fd));
+          return driver->ring_ >= 0 ? std::move(driver) : nullptr;
+      }
+
+      ~IoUringDriver() override {
+          if (sqes_ != MAP_FAILED) {
+              ::munmap(sqes_, sqesSize_);
+          }
+          if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+              ::munmap(cqRing_, cqSize_);
+          }
+          if (sqRing_ != MAP_FAILED) {
+              ::munmap(sqRing_, sqSize_);
+          }
+          if (ring_ >= 0) {
+              ::close(ring_);
+          }
+      }
+
+      Backend backend() const override { return Backend::IoUring; }
+
+      void submit(std::size_t slot, std::string_view data) override {
+          // Only this thread adds entries, so the tail needs no atomic update;
+          // the release store is what hands the entry to the kernel
+          unsigned tail = *sqTail_;
+          unsigned index = tail & *sqMask_;
+          io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes_)[index];
+          std::memset(&sqe, 0, sizeof(sqe));
+          sqe.opcode = IORING_OP_WRITE;
+          sqe.fd = fd_;
+          sqe.addr = reinterpret_cast<std::uint64_t>(data.data());
+          sqe.len = static_cast<std::uint32_t>(std::min<std::size_t>(data.size(), 1u << 30));
+          sqe.off = static_cast<std::uint64_t>(-1);   // At the current file position, like write()
+          sqe.user_data = slot;
+          // Straight to a kernel worker: otherwise a buffered file write is
+          // copied into the page cache inside io_uring_enter, on this thread
+          sqe.flags = IOSQE_ASYNC;
+          sqArray_[index] = index;
+          std::atomic_ref<unsigned>(*sqTail_).store(tail + 1, std::memory_order_release);
+          while (enter(1, 0, 0) < 0) {
+              if (errno != EINTR) {
+                  // Nothing was submitted: take the entry back so a later call does not send it
+                  int error = errno;
+                  std::atomic_ref<unsigned>(*sqTail_).store(tail, std::memory_order_release);
+                  throw std::runtime_error(std::string("io_uring_enter: ") + std::strerror(error));
+              }
+          }
+      }
+
+      Completion wait() override {
+          for (;;) {
+              unsigned head = *cqHead_;
+              if (head != std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire)) {
+                  const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+                  Completion completion{static_cast<std::size_t>(cqe.user_data), cqe.res};
+                  std::atomic_ref<unsigned>(*cqHead_).store(head + 1, std::memory_order_release);
+                  return completion;
+              }
+              if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                  throw std::runtime_error(std::string("io_uring_enter: ") + std::strerror(errno));
+              }
+          }
+      }
+
+  private:
+      explicit IoUringDriver(int fd) : fd_(fd) {
+          io_uring_params params{};
+          ring_ = static_cast<int>(::syscall(__NR_io_uring_setup, kEntries, &params));
+          if (ring_ < 0) {
+              return;
+          }
+          // IORING_OP_WRITE needs Linux 5.6, which also brought RW_CUR_POS
+          if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+              fail();
+              return;
+          }
+          sqSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+          cqSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+          bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+          if (singleMap) {
+              sqSize_ = cqSize_ = std::max(sqSize_, cqSize_);
+          }
+          sqRing_ = ::mmap(nullptr, sqSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_SQ_RING);
+          cqRing_ = singleMap ? sqRing_
+                              : ::mmap(nullptr, cqSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_CQ_RING);
+          sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+          sqes_ = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_SQES);
+          if (sqRing_ == MAP_FAILED || cqRing_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+              fail();
+              return;
+          }
+          char* sq = static_cast<char*>(sqRing_);
+          sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+          sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+          sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+          char* cq = static_cast<char*>(cqRing_);
+          cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+          cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+          cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+          cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+      }
+
+      void fail() {
+          ::close(ring_);
+          ring_ = -1;
+      }
+
+      int enter(unsigned toSubmit, unsigned minComplete, unsigned flags) {
+          return static_cast<int>(::syscall(__NR_io_uring_enter, ring_, toSubmit, minComplete, flags, nullptr, 0));
+      }
+
+      int fd_;
+      int ring_ = -1;
+      void* sqRing_ = MAP_FAILED;
+      void* cqRing_ = MAP_FAILED;
+      void* sqes_ = MAP_FAILED;
+      std::size_t sqSize_ = 0;
+      std::size_t cqSize_ = 0;
+      std::size_t sqesSize_ = 0;
+      unsigned* sqTail_ = nullptr;
+      unsigned* sqMask_ = nullptr;
+      unsigned* sqArray_ = nullptr;
+      unsigned* cqHead_ = nullptr;
+      unsigned* cqTail_ = nullptr;
+      unsigned* cqMask_ = nullptr;
+      io_uring_cqe* cqes_ = nullptr;
+};
+
+#endif
+
+}
+
+// ----- Task -----
+
+Task& Task::operator=(Task&& other) noexcept {
+    if (this != &other) {
+        if (handle_) {
+            handle_.destroy();
+        }
+        handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+}
+
+Task::~Task() {
+    if (handle_) {
+        handle_.destroy();
+    }
+}
+
+// ----- WriteOperation -----
+
+WriteOperation::~WriteOperation() {
+    if (loop_ != nullptr) {
+        // The buffer must not go away while the kernel may still read it.
+        // Nothing in flight means the write was never submitted (submit threw).
+        try {
+            while (!loop_->writes_[slot_].done && loop_->inFlight_) {
+                loop_->complete();
+            }
+        } catch (...) {
+            // Destructors are noexcept; a co_await on the write is what reports errors
+        }
+        loop_->release(slot_);
+    }
+}
+
+bool WriteOperation::Awaiter::await_ready() const {
+    return operation_.loop_->writes_[operation_.slot_].done;
+}
+
+void WriteOperation::Awaiter::await_suspend(std::coroutine_handle<> waiter) {
+    operation_.loop_->writes_[operation_.slot_].waiter = waiter;
+}
+
+void WriteOperation::Awaiter::await_resume() {
+    int error = std::exchange(operation_.loop_, nullptr)->release(operation_.slot_);
+    if (error != 0) {
+        throw std::runtime_error(std::string("asynchronous write failed: ") + std::strerror(error));
+    }
+}
+
+// ----- EventLoop -----
+
+EventLoop::EventLoop(int fd, Backend preferred) {
+#if MYPROJECT_HAS_IO_URING
+    // A write to a full pipe or socket completes short (after 64 KiB for a
+    // pipe) even on a kernel worker, and the rest could only be submitted
+    // at the next co_await. The worker thread keeps writing until it is done.
+    struct stat info{};
+    bool stream = ::fstat(fd, &info) == 0 && (S_ISFIFO(info.st_mode) || S_ISSOCK(info.st_mode));
+    if (preferred == Backend::IoUring && !stream) {
+        driver_ = IoUringDriver::create(fd);
+    }
+#else
+    (void)preferred;
+#endif
+    if (!driver_) {
+        driver_ = std::make_unique<ThreadDriver>(fd);
+    }
+}
+
+// Destroying the tasks first lets their pending writes finish on the driver
+EventLoop::~EventLoop() {
+    tasks_.clear();
+}
+
+Backend EventLoop::backend() const {
+    return driver_->backend();
+}
+
+WriteOperation EventLoop::write(std::string_view data) {
+    for (std::size_t slot = 0; slot < writes_.size(); slot++) {
+        Write& w = writes_[slot];
+        if (!w.used) {
+            w = Write{true, data.empty(), 0, data, {}};
+            if (!w.done) {
+                queued_.push_back(slot);
+                startNext();
+            }
+            return WriteOperation(this, slot);
+        }
+    }
+    throw std::logic_error("EventLoop: too many writes in flight");
+}
+
+void EventLoop::startNext() {
+    if (!inFlight_ && !queued_.empty()) {
+        std::size_t slot = queued_.front();
+        driver_->submit(slot, writes_[slot].remaining);
+        inFlight_ = true;
+    }
+}
+
+void EventLoop::complete() {
+    Driver::Completion completion = driver_->wait();
+    inFlight_ = false;
+    Write& w = writes_[completion.slot];
+    if (completion.result == -EINTR || completion.result == -EAGAIN) {
+        // Not written at all: try again
+    } else if (completion.result <= 0) {
+        w.error = completion.result < 0 ? static_cast<int>(-completion.result) : EIO;
+        w.done = true;
+    } else {
+        // A short write (pipes, signals) submits the rest next
+        w.remaining.remove_prefix(static_cast<std::size_t>(completion.result));
+        w.done = w.remaining.empty();
+    }
+    if (w.done) {
+        queued_.pop_front();
+        if (w.waiter) {
+            ready_.push_back(std::exchange(w.waiter, {}));
+        }
+    }
+    startNext();
+}
+
+int EventLoop::release(std::size_t slot) {
+    int error = writes_[slot].error;
+    std::erase(queued_, slot);   // Only still there if the write never finished
+    writes_[slot] = Write{};
+    return error;
+}
+
+void EventLoop::spawn(Task task) {
+    ready_.push_back(task.handle_);
+    tasks_.push_back(std::move(task));
+}
+
+void EventLoop::run() {
+    std::exception_ptr failure;
+    for (;;) {
+        while (!ready_.empty()) {
+            std::coroutine_handle<> next = ready_.front();
+            ready_.pop_front();
+            next.resume();
+        }
+        for (std::size_t i = 0; i < tasks_.size();) {
+            if (tasks_[i].handle_.done()) {
+                if (!failure) {
+                    failure = tasks_[i].handle_.promise().exception;
+                }
+                tasks_.erase(tasks_.begin() + static_cast<std::ptrdiff_t>(i));
+            } else {
+                i++;
+            }
+        }
+        if (tasks_.empty()) {
+            break;
+        }
+        if (!inFlight_) {
+            throw std::logic_error("EventLoop: every task is waiting, but nothing is being written");
+        }
+        complete();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+}
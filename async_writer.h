@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+ * Asynchronous writes driven by C++20 coroutines (similar to async/await
+ * with Stream.WriteAsync in C#, or to `await fs.promises.write()` in
+ * Node.js, where the event loop also lives in the runtime).
+ *
+ * EventLoop::write() starts writing a buffer and returns at once; the
+ * coroutine keeps computing and only `co_await`s the write when it needs
+ * the buffer back. With two buffers, the next chunk is formatted while the
+ * previous one drains, so a slow pipe or network filesystem no longer
+ * stalls the computation on every flush:
+ *
+ *     async_io::Task report(async_io::EventLoop& loop) {
+ *         auto pending = loop.write(first);    // Starts draining...
+ *         fill(second);                        // ...while this runs
+ *         co_await pending;                    // `first` may be reused now
+ *         ...
+ *     }
+ *
+ *     async_io::EventLoop loop(STDOUT_FILENO);
+ *     loop.spawn(report(loop));
+ *     loop.run();
+ *
+ * On Linux, writes to files and devices go through io_uring (raw system
+ * calls, no liburing). Pipes and sockets, and systems where io_uring is
+ * missing or not allowed (old kernels, seccomp, not Linux), use a worker
+ * thread doing blocking write() calls instead. Writes to one loop always
+ * reach the file descriptor in the order they were started.
+ */
+namespace async_io {
+
+enum class Backend {
+    IoUring,
+    Thread,
+};
+
+// "io_uring" or "thread"; throws std::invalid_argument otherwise
+Backend parseBackend(std::string_view name);
+const char* backendName(Backend backend);
+
+// The coroutine type for code run by an EventLoop. It starts when the loop
+// first runs it; an exception thrown inside comes out of EventLoop::run.
+class Task {
+  public:
+      struct promise_type {
+          std::exception_ptr exception;
+
+          Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+          std::suspend_always initial_suspend() noexcept { return {}; }
+          std::suspend_always final_suspend() noexcept { return {}; }
+          void return_void() {}
+          void unhandled_exception() { exception = std::current_exception(); }
+      };
+
+      Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+      Task& operator=(Task&& other) noexcept;
+      ~Task();
+
+      Task(const Task&) = delete;
+      Task& operator=(const Task&) = delete;
+
+  private:
+      friend class EventLoop;
+      explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+      std::coroutine_handle<promise_type> handle_;
+};
+
+class EventLoop;
+
+// A write in flight, returned by EventLoop::write. `co_await` it to wait
+// for every byte to be written (it throws std::runtime_error if the write
+// failed). Destroying it without awaiting waits for the write as well.
+class WriteOperation {
+  public:
+      WriteOperation(WriteOperation&& other) noexcept
+          : loop_(std::exchange(other.loop_, nullptr)), slot_(other.slot_) {}
+      WriteOperation& operator=(WriteOperation&&) = delete;
+      ~WriteOperation();
+
+      // What `co_await operation` waits on. The operation is referenced,
+      // not copied: it is move-only and the loop knows it by its slot.
+      class Awaiter {
+        public:
+            explicit Awaiter(WriteOperation& operation) : operation_(operation) {}
+            bool await_ready() const;
+            void await_suspend(std::coroutine_handle<> waiter);
+            void await_resume();
+
+        private:
+            WriteOperation& operation_;
+      };
+
+      Awaiter operator co_await() & { return Awaiter(*this); }
+      Awaiter operator co_await() && { return Awaiter(*this); }
+
+  private:
+      friend class EventLoop;
+      WriteOperation(EventLoop* loop, std::size_t slot) : loop_(loop), slot_(slot) {}
+
+      EventLoop* loop_;
+      std::size_t slot_;
+};
+
+class EventLoop {
+  public:
+      static constexpr std::size_t kMaxWrites = 8;   // Started but not awaited
+
+      // Uses `preferred` when this system and `fd` suit it, the thread backend otherwise
+      explicit EventLoop(int fd, Backend preferred = Backend::IoUring);
+      ~EventLoop();
+
+      EventLoop(const EventLoop&) = delete;
+      EventLoop& operator=(const EventLoop&) = delete;
+
+      Backend backend() const;
+
+      // Starts writing `data`, which must stay valid until the write has
+      // been awaited. Throws std::logic_error with kMaxWrites already pending.
+      WriteOperation write(std::string_view data);
+
+      void spawn(Task task);
+
+      // Runs the spawned tasks until all of them have finished, then
+      // rethrows the first exception any of them threw
+      void run();
+
+      // The operating system part: io_uring or the worker thread
+      class Driver;
+
+  private:
+      friend class WriteOperation;
+
+      struct Write {
+          bool used = false;
+          bool done = false;
+          int error = 0;                       // errno of a failed write
+          std::string_view remaining;          // Not written yet
+          std::coroutine_handle<> waiter;      // Resumed when done
+      };
+
+      // Hands the oldest queued write to the driver, if none is in flight
+      void startNext();
+      // Waits for one completion from the driver and applies it
+      void complete();
+      // Frees a finished write's slot; returns its errno (0 if it succeeded)
+      int release(std::size_t slot);
+
+      std::unique_ptr<Driver> driver_;
+      std::array<Write, kMaxWrites> writes_;
+      std::deque<std::size_t> queued_;          // Started, in order; the front one is in flight
+      bool inFlight_ = false;
+      std::deque<std::coroutine_handle<>> ready_;
+      std::vector<Task> tasks_;
+};
+
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "alloc_counter.h"
+
+/*
+ * A tiny benchmark harness: run a body over N items, time it with
+ * steady_clock, count the heap allocations it made and print one row per
+ * measurement. Each suite (bench_io.cpp, ...) is a function registered in
+ * bench_main.cpp.
+ *
+ * Like google-benchmark, a body runs once untimed to warm the caches and
+ * fault in its memory, then again until it has run kMinRepetitions times
+ * and for kMinSeconds; the median run is reported. A single run would
+ * include first-touch page faults and whatever else the machine was doing.
+ *
+ * Every suite that takes its sizes from --records runs once per input size
+ * (--records 1000,1000000); the ones with fixed sizes run once. All results
+ * can be saved as JSON (--json) to compare one build against the next. The
+ * tutorial suite runs the MyProject binary built from the same tree.
+ */
+namespace bench {
+
+struct Config {
+    std::size_t records = 1'000'000;   // Items per measurement (--records)
+    std::string outputDir = ".";       // Where file-backed targets write (--output-dir)
+    bool large = false;                // Also run the sizes that need many GB of memory (--large)
+};
+
+struct Result {
+    std::string name;           // What was measured, e.g. "cout chaining"
+    std::string variant;        // How or where, e.g. "/dev/null"
+    std::size_t items = 0;      // Records, elements, ... processed
+    double seconds = 0;
+    std::size_t bytes = 0;      // Bytes produced or consumed (0 if not meaningful)
+    std::size_t allocations = 0;
+    std::size_t repetitions = 1;   // Timed runs; seconds and allocations are the median run's
+
+    double nsPerItem() const { return items ? seconds * 1e9 / static_cast<double>(items) : 0; }
+    double bytesPerSecond() const { return seconds > 0 ? static_cast<double>(bytes) / seconds : 0; }
+    double allocationsPerItem() const {
+        return items ? static_cast<double>(allocations) / static_cast<double>(items) : 0;
+    }
+};
+
+// Keeps the optimizer from deleting a computation whose result is unused
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Swallows everything, so code that prints can be measured without real output
+class NullBuffer : public std::streambuf {
+  protected:
+      int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+      std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+inline constexpr std::size_t kMinRepetitions = 3;
+inline constexpr std::size_t kMaxRepetitions = 100;
+inline constexpr double kMinSeconds = 0.2;
+
+namespace detail {
+
+// One run of body(); a returned byte count goes into `result`
+template <typename F>
+Result timeOnce(Result result, F& body) {
+    AllocationCounts before = allocationCounts();
+    auto start = std::chrono::steady_clock::now();
+    if constexpr (std::is_void_v<std::invoke_result_t<F&>>) {
+        body();
+    } else {
+        result.bytes = static_cast<std::size_t>(body());
+    }
+    auto stop = std::chrono::steady_clock::now();
+    result.allocations = (allocationCounts() - before).allocations;
+    result.seconds = std::chrono::duration<double>(stop - start).count();
+    return result;
+}
+
+}
+
+// Runs setup() and then body() for the warm-up and for every timed run;
+// only body() is timed. setup puts back whatever body used up (a sorted
+// vector, a filled map, moved-from strings), so every run does the same work.
+// If body returns a byte count it is recorded as well.
+template <typename Setup, typename F>
+Result measure(std::string name, std::string variant, std::size_t items, Setup&& setup, F&& body) {
+    const Result empty{std::move(name), std::move(variant), items};
+    setup();
+    detail::timeOnce(empty, body);   // Warm-up
+    std::vector<Result> runs;
+    double total = 0;
+    while (runs.size() < kMinRepetitions || (total < kMinSeconds && runs.size() < kMaxRepetitions)) {
+        setup();
+        runs.push_back(detail::timeOnce(empty, body));
+        total += runs.back().seconds;
+    }
+    auto median = runs.begin() + static_cast<std::ptrdiff_t>(runs.size() / 2);
+    std::nth_element(runs.begin(), median, runs.end(),
+                     [](const Result& a, const Result& b) { return a.seconds < b.seconds; });
+    Result result = std::move(*median);
+    result.repetitions = runs.size();
+    return result;
+}
+
+template <typename F>
+Result measure(std::string name, std::string variant, std::size_t items, F&& body) {
+    return measure(std::move(name), std::move(variant), items, [] {}, body);
+}
+
+// A single run without warm-up, for a body that is itself many repetitions
+// with its own statistics (the startup suite's launches)
+template <typename F>
+Result measureOnce(std::string name, std::string variant, std::size_t items, F&& body) {
+    return detail::timeOnce(Result{std::move(name), std::move(variant), items}, body);
+}
+
+class Reporter {
+  public:
+      explicit Reporter(std::ostream& os) : os_(os) {}
+
+      // The suite and input size the next results belong to (for the JSON);
+      // records 0 for a suite with fixed sizes, whose results then record
+      // their own item counts
+      void begin(std::string_view suite, std::size_t records);
+
+      void section(std::string_view title);
+      void add(const Result& result);
+      void note(std::string_view text);   // A free-form line under the table
+
+      // Every result so far, one object each, for regression tracking:
+      // {"benchmarks": [{"suite", "records", "section", "name", "variant",
+      //  "items", "repetitions", "seconds", "ns_per_item",
+      //  "bytes_per_second", "allocations_per_item"}, ...]}
+      void writeJson(std::ostream& os) const;
+
+  private:
+      struct Entry {
+          std::string suite;
+          std::size_t records;
+          std::string section;
+          Result result;
+      };
+
+      std::ostream& os_;
+      std::string suite_;
+      std::size_t records_ = 0;
+      std::string section_;
+      std::vector<Entry> entries_;
+};
+
+// ----- Suites (in the bench_*.cpp files) -----
+void runIoBenchmarks(const Config& config, Reporter& reporter);
+void runParseBenchmarks(const Config& config, Reporter& reporter);
+void runPersonBenchmarks(const Config& config, Reporter& reporter);
+void runTableBenchmarks(const Config& config, Reporter& reporter);
+void runDispatchBenchmarks(const Config& config, Reporter& reporter);
+void runAllocBenchmarks(const Config& config, Reporter& reporter);
+void runKernelBenchmarks(const Config& config, Reporter& reporter);
+void runMapBenchmarks(const Config& config, Reporter& reporter);
+void runPipelineBenchmarks(const Config& config, Reporter& reporter);
+void runErrorBenchmarks(const Config& config, Reporter& reporter);
+void runLogQueueBenchmarks(const Config& config, Reporter& reporter);
+void runAsyncBenchmarks(const Config& config, Reporter& reporter);
+void runPoolBenchmarks(const Config& config, Reporter& reporter);
+void runUtfBenchmarks(const Config& config, Reporter& reporter);
+void runTutorialBenchmarks(const Config& config, Reporter& reporter);
+void runStartupBenchmarks(const Config& config, Reporter& reporter);
+
+}
@@ -0,0 +1,161 @@
+// Heap allocations per Person/Employee operation. The names are longer
+// than the small-string buffer (15 characters in libstdc++), so every
+// string copy shows up as an allocation. The second table is the memory
+// an Employee takes with its company as a std::string of its own (as it
+// used to be) versus an interned id.
+
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "output_sink.h"
+#include "interned_string.h"
+#include "person.h"
+#include "bench.h"
+
+namespace {
+
+using QuietPerson = BasicPerson<NoLogging>;
+using QuietEmployee = BasicEmployee<NoLogging>;
+
+const std::string kLongName = "Maximilian Alexander";
+const std::string kLongCompany = "Consolidated Widgets Inc";
+
+std::vector<std::string> makeNames(std::size_t n) {
+    return std::vector<std::string>(n, kLongName);
+}
+
+// The Employee layout before company interning
+struct StringCompanyEmployee {
+    QuietPerson person;
+    std::string company;
+};
+
+// sizeof plus the heap bytes allocated while constructing, per employee
+template <typename T>
+double bytesPerEmployee(std::size_t n, const std::string& company) {
+    std::vector<T> roster;
+    roster.reserve(n);
+    AllocationCounts before = allocationCounts();
+    for (std::size_t i = 0; i < n; i++) {
+        if constexpr (std::is_same_v<T, StringCompanyEmployee>) {
+            roster.push_back(T{QuietPerson("Alice", 30), company});
+        } else {
+            roster.emplace_back("Alice", 30, company);
+        }
+    }
+    std::size_t heap = (allocationCounts() - before).bytes;
+    return static_cast<double>(sizeof(T)) + static_cast<double>(heap) / static_cast<double>(n);
+}
+
+std::string formatBytes(double bytes) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f", bytes);
+    return text;
+}
+
+}
+
+namespace bench {
+
+void runAllocBenchmarks(const Config& config, Reporter& reporter) {
+    const std::size_t n = config.records;
+    reporter.section("Allocations per Person operation (items = operations)");
+
+    reporter.add(measure("construct from literal", "Person", n, [&] {
+        for (std::size_t i = 0; i < n; i++) {
+            QuietPerson p("Maximilian Alexander", 30);
+            doNotOptimize(p);
+        }
+    }));
+    reporter.add(measure("construct from const&", "Person", n, [&] {
+        for (std::size_t i = 0; i < n; i++) {
+            QuietPerson p(kLongName, 30);
+            doNotOptimize(p);
+        }
+    }));
+    {
+        std::vector<std::string> names;
+        reporter.add(measure("construct from std::move", "Person", n, [&] { names = makeNames(n); }, [&] {
+            for (std::size_t i = 0; i < n; i++) {
+                QuietPerson p(std::move(names[i]), 30);
+                doNotOptimize(p);
+            }
+        }));
+    }
+
+    QuietPerson person(kLongName, 30);
+    {
+        std::vector<std::string> names;
+        reporter.add(measure("setName(std::move)", "Person", n, [&] { names = makeNames(n); }, [&] {
+            for (std::size_t i = 0; i < n; i++) {
+                person.setName(std::move(names[i]));
+            }
+        }));
+    }
+    reporter.add(measure("name() / getName()", "Person", n, [&] {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            total += person.name().size() + person.getName().size();
+        }
+        doNotOptimize(total);
+    }));
+    // What every getName() call used to cost when it returned by value
+    reporter.add(measure("copy of getName()", "Person", n, [&] {
+        for (std::size_t i = 0; i < n; i++) {
+            std::string copy = person.getName();
+            doNotOptimize(copy);
+        }
+    }));
+
+    QuietEmployee employee(kLongName, 30, kLongCompany);
+    NullBuffer nullBuffer;
+    std::ostream nullStream(&nullBuffer);
+    {
+        ScopedOutput redirect(nullStream);
+        reporter.add(measure("introduce()", "Person", n, [&] {
+            for (std::size_t i = 0; i < n; i++) {
+                person.introduce();
+            }
+        }));
+        reporter.add(measure("introduce()", "Employee", n, [&] {
+            for (std::size_t i = 0; i < n; i++) {
+                employee.introduce();
+            }
+        }));
+    }
+    std::string text;
+    reporter.add(measure("appendIntroduction()", "Employee", n, [&] {
+        for (std::size_t i = 0; i < n; i++) {
+            text.clear();
+            employee.appendIntroduction(text);
+        }
+        doNotOptimize(text);
+    }));
+
+    reporter.section("Memory per Employee, std::string company vs interned (items = employees)");
+    for (const std::string& company : {std::string("Acme Inc"), kLongCompany}) {
+        reporter.add(measure("construct", "std::string", n, [&] {
+            std::vector<StringCompanyEmployee> roster;
+            roster.reserve(n);
+            for (std::size_t i = 0; i < n; i++) {
+                roster.push_back(StringCompanyEmployee{QuietPerson("Alice", 30), company});
+            }
+        }));
+        reporter.add(measure("construct", "interned", n, [&] {
+            std::vector<QuietEmployee> roster;
+            roster.reserve(n);
+            for (std::size_t i = 0; i < n; i++) {
+                roster.emplace_back("Alice", 30, company);
+            }
+        }));
+        reporter.note("\"" + company + "\": " + formatBytes(bytesPerEmployee<StringCompanyEmployee>(n, company))
+                      + " bytes per Employee with a std::string company, "
+                      + formatBytes(bytesPerEmployee<QuietEmployee>(n, company)) + " interned");
+    }
+    reporter.note("Shared pool: " + std::to_string(SharedStringPool::global().size()) + " strings, "
+                  + std::to_string(SharedStringPool::global().memoryUsage()) + " bytes in total");
+}
+
+}
@@ -0,0 +1,171 @@
+// The --numbers report (number_report.h) written chunk by chunk, either
+// synchronously (format a chunk, write it, format the next) or through the
+// coroutine EventLoop with each backend, where the next chunk is formatted
+// while the previous one drains. Destinations: a regular file, /dev/null,
+// and a pipe whose reader takes a 1 ms nap per MiB, like a slow network
+// filesystem would.
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if __has_include(<unistd.h>) && __has_include(<fcntl.h>)
+#include <fcntl.h>
+#include <unistd.h>
+#define MYPROJECT_BENCH_HAS_POSIX_IO 1
+#else
+#define MYPROJECT_BENCH_HAS_POSIX_IO 0
+#endif
+
+#include "async_writer.h"
+#include "format_buffer.h"
+#include "number_report.h"
+#include "bench.h"
+
+#if MYPROJECT_BENCH_HAS_POSIX_IO
+
+namespace {
+
+void writeAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t count = ::write(fd, data.data(), data.size());
+        if (count < 0) {
+            throw std::runtime_error("write failed");
+        }
+        data.remove_prefix(static_cast<std::size_t>(count));
+    }
+}
+
+std::size_t writeSync(int fd, std::size_t rows) {
+    FormatBuffer buffer;
+    std::size_t bytes = 0;
+    for (std::size_t first = 0; first < rows; first += kNumberReportChunkRows) {
+        buffer.clear();
+        appendNumberReport(buffer, first, std::min(rows, first + kNumberReportChunkRows));
+        writeAll(fd, buffer.view());
+        bytes += buffer.size();
+    }
+    return bytes;
+}
+
+void writeAsync(int fd, std::size_t rows, async_io::Backend backend) {
+    async_io::EventLoop loop(fd, backend);
+    loop.spawn(writeNumberReport(loop, rows));
+    loop.run();
+}
+
+// Drains the read end of a pipe, napping 1 ms after every MiB
+class SlowReader {
+  public:
+      SlowReader() {
+          int fds[2];
+          if (::pipe(fds) != 0) {
+              throw std::runtime_error("pipe failed");
+          }
+          readFd_ = fds[0];
+          writeFd_ = fds[1];
+          reader_ = std::thread([this] {
+              char block[64 * 1024];
+              std::size_t sinceNap = 0;
+              ssize_t count;
+              while ((count = ::read(readFd_, block, sizeof(block))) > 0) {
+                  sinceNap += static_cast<std::size_t>(count);
+                  if (sinceNap >= 1024 * 1024) {
+                      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                      sinceNap = 0;
+                  }
+              }
+          });
+      }
+
+      int fd() const { return writeFd_; }
+
+      // Closes the write end and waits until the reader has seen everything
+      void finish() {
+          ::close(writeFd_);
+          reader_.join();
+          ::close(readFd_);
+      }
+
+  private:
+      int readFd_ = -1;
+      int writeFd_ = -1;
+      std::thread reader_;
+};
+
+}
+
+#endif
+
+namespace bench {
+
+void runAsyncBenchmarks(const Config& config, Reporter& reporter) {
+    reporter.section("Number report, chunked writes (items = rows)");
+#if MYPROJECT_BENCH_HAS_POSIX_IO
+    const std::size_t rows = config.records;
+    const std::filesystem::path filePath = std::filesystem::path(config.outputDir) / "bench_async.out";
+    const std::string file = filePath.string();
+
+    struct Strategy {
+        const char* name;
+        bool async;
+        async_io::Backend backend;
+    };
+    const Strategy strategies[] = {
+        {"sync", false, async_io::Backend::Thread},
+        {"async (thread)", true, async_io::Backend::Thread},
+        {"async (io_uring)", true, async_io::Backend::IoUring},
+    };
+    std::size_t bytes = 0;
+    for (const Strategy& strategy : strategies) {
+        if (strategy.async) {
+            int null = ::open("/dev/null", O_WRONLY);
+            bool available = async_io::EventLoop(null, strategy.backend).backend() == strategy.backend;
+            ::close(null);
+            if (!available) {
+                reporter.note(std::string(strategy.name) + ": not available here, skipped");
+                continue;
+            }
+        }
+        auto run = [&](int fd) {
+            if (strategy.async) {
+                writeAsync(fd, rows, strategy.backend);
+            } else {
+                bytes = writeSync(fd, rows);
+            }
+        };
+        Result toFile = measure(strategy.name, "file", rows, [&] {
+            int fd = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                throw std::runtime_error("cannot open " + file);
+            }
+            run(fd);
+            ::close(fd);
+        });
+        Result toNull = measure(strategy.name, "/dev/null", rows, [&] {
+            int fd = ::open("/dev/null", O_WRONLY);
+            run(fd);
+            ::close(fd);
+        });
+        Result toPipe = measure(strategy.name, "slow pipe", rows, [&] {
+            SlowReader reader;
+            run(reader.fd());
+            reader.finish();
+        });
+        for (Result* result : {&toFile, &toNull, &toPipe}) {
+            result->bytes = bytes;
+            reporter.add(*result);
+        }
+    }
+    reporter.note("async (io_uring) on the slow pipe runs the thread backend: the loop picks it for pipes");
+    std::filesystem::remove(filePath);
+#else
+    (void)config;
+    reporter.note("skipped: needs POSIX file descriptors");
+#endif
+}
+
+}
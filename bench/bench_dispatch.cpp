@@ -0,0 +1,105 @@
+// Dispatch over a mixed roster (two Persons for every Employee): virtual
+// functions, CRTP with one vector per type, and std::variant + std::visit.
+// "length" is a cheap call where the dispatch itself dominates, "append"
+// builds the full introduction text into a reused string.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "person_dispatch.h"
+#include "bench.h"
+
+namespace {
+
+const std::string kNames[] = {"Alice", "Bob", "Charlie", "Dave", "Eve", "Mallory", "Trent", "Peggy"};
+const std::string kCompany = "Acme Inc";
+
+using QuietPerson = BasicPerson<NoLogging>;
+using QuietEmployee = BasicEmployee<NoLogging>;
+
+bool isEmployee(std::size_t i) {
+    return i % 3 == 2;
+}
+
+int ageFor(std::size_t i) {
+    return 18 + static_cast<int>(i % 60);
+}
+
+}
+
+namespace bench {
+
+void runDispatchBenchmarks(const Config& config, Reporter& reporter) {
+    const std::size_t n = config.records;
+    reporter.section("Dispatch over a mixed roster (items = calls)");
+
+    std::vector<std::unique_ptr<VirtualPerson>> virtualRoster;
+    StaticRoster<NoLogging> staticRoster;
+    std::vector<AnyPerson<NoLogging>> variantRoster;
+    virtualRoster.reserve(n);
+    variantRoster.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        const std::string& name = kNames[i % 8];
+        if (isEmployee(i)) {
+            virtualRoster.push_back(std::make_unique<VirtualPersonOf<QuietEmployee>>(name, ageFor(i), kCompany));
+            staticRoster.employees.emplace_back(name, ageFor(i), kCompany);
+            variantRoster.emplace_back(std::in_place_type<QuietEmployee>, name, ageFor(i), kCompany);
+        } else {
+            virtualRoster.push_back(std::make_unique<VirtualPersonOf<QuietPerson>>(name, ageFor(i)));
+            staticRoster.people.emplace_back(name, ageFor(i));
+            variantRoster.emplace_back(std::in_place_type<QuietPerson>, name, ageFor(i));
+        }
+    }
+
+    std::size_t total = 0;
+    reporter.add(measure("length", "virtual", n, [&] {
+        total = 0;
+        for (const auto& p : virtualRoster) {
+            total += p->introductionLength();
+        }
+    }));
+    reporter.add(measure("length", "CRTP", n, [&] {
+        total = 0;
+        staticRoster.forEach([&total](const auto& p) { total += p.introductionLength(); });
+    }));
+    reporter.add(measure("length", "variant", n, [&] {
+        total = 0;
+        for (const auto& p : variantRoster) {
+            total += introductionLength(p);
+        }
+    }));
+    doNotOptimize(total);
+
+    std::string text;
+    text.reserve(256);
+    reporter.add(measure("append", "virtual", n, [&] {
+        std::size_t bytes = 0;
+        for (const auto& p : virtualRoster) {
+            text.clear();
+            p->appendIntroduction(text);
+            bytes += text.size();
+        }
+        return bytes;
+    }));
+    reporter.add(measure("append", "CRTP", n, [&] {
+        std::size_t bytes = 0;
+        staticRoster.forEach([&](const auto& p) {
+            text.clear();
+            p.appendIntroduction(text);
+            bytes += text.size();
+        });
+        return bytes;
+    }));
+    reporter.add(measure("append", "variant", n, [&] {
+        std::size_t bytes = 0;
+        for (const auto& p : variantRoster) {
+            text.clear();
+            appendIntroduction(p, text);
+            bytes += text.size();
+        }
+        return bytes;
+    }));
+}
+
+}
@@ -0,0 +1,90 @@
+// Exceptions versus Expected (checked.h) for division and element access,
+// at error rates of 0%, 1%, 10% and 50%. The failing items are spread
+// evenly through the input, so the branch predictor cannot learn them.
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "checked.h"
+#include "bench.h"
+
+namespace {
+
+// true for about `percent`% of the n items, in random positions
+std::vector<bool> failures(std::size_t n, int percent) {
+    std::mt19937 random(static_cast<unsigned>(percent) + 1);
+    std::uniform_int_distribution<int> roll(0, 99);
+    std::vector<bool> failing(n);
+    for (std::size_t i = 0; i < n; i++) {
+        failing[i] = roll(random) < percent;
+    }
+    return failing;
+}
+
+}
+
+namespace bench {
+
+void runErrorBenchmarks(const Config& config, Reporter& reporter) {
+    const std::size_t n = config.records;
+    const std::vector<int> values(1024, 7);
+    for (int percent : {0, 1, 10, 50}) {
+        reporter.section("Error channel at " + std::to_string(percent) + "% errors (items = calls)");
+        std::vector<bool> failing = failures(n, percent);
+
+        std::vector<int> denominators(n);
+        std::vector<std::size_t> indices(n);
+        for (std::size_t i = 0; i < n; i++) {
+            denominators[i] = failing[i] ? 0 : 3;
+            indices[i] = failing[i] ? values.size() + i : i % values.size();
+        }
+
+        long long total = 0;
+        std::size_t errors = 0;
+        reporter.add(measure("divide", "exception", n, [&] {
+            for (int d : denominators) {
+                try {
+                    total += divideOrThrow(1000, d);
+                } catch (const std::runtime_error&) {
+                    errors++;
+                }
+            }
+        }));
+        reporter.add(measure("divide", "expected", n, [&] {
+            for (int d : denominators) {
+                Expected<int, ErrorCode> result = checkedDivide(1000, d);
+                if (result) {
+                    total += *result;
+                } else {
+                    errors++;
+                }
+            }
+        }));
+        reporter.add(measure("element access", "vector::at", n, [&] {
+            for (std::size_t index : indices) {
+                try {
+                    total += values.at(index);
+                } catch (const std::out_of_range&) {
+                    errors++;
+                }
+            }
+        }));
+        reporter.add(measure("element access", "expected", n, [&] {
+            for (std::size_t index : indices) {
+                Expected<int, ErrorCode> result = checkedAt(values, index);
+                if (result) {
+                    total += *result;
+                } else {
+                    errors++;
+                }
+            }
+        }));
+        doNotOptimize(total);
+        doNotOptimize(errors);
+    }
+}
+
+}
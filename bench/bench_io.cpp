@@ -0,0 +1,252 @@
+// Measures the output methods shown in demonstrateModernIO (main.cpp).
+// Every strategy writes the same record (the int `num` and the double `pi`
+// from the demo) N times, once into a regular file and once into /dev/null.
+// The last table prints N rows of the hex/decimal/fixed/scientific block,
+// with manipulators and with appendNumberTable (format_buffer.h).
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+#include "format_buffer.h"
+#include "bench.h"
+
+namespace {
+
+constexpr int num = 42;
+constexpr double pi = 3.14159265359;
+
+// 1. Plain chaining; the precision is set once up front
+void coutChaining(std::ostream& os, std::size_t records) {
+    os << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i < records; i++) {
+        os << "Number: " << num << ", Pi: " << pi << '\n';
+    }
+}
+
+// 2. Manipulators flipped and reset on every record, like the demo does
+void manipulators(std::ostream& os, std::size_t records) {
+    for (std::size_t i = 0; i < records; i++) {
+        os << "Hex: " << std::hex << std::showbase << num
+           << ", Decimal: " << std::dec << num
+           << ", Pi: " << std::fixed << std::setprecision(2) << pi
+           << std::defaultfloat << std::setprecision(6) << '\n';
+    }
+}
+
+// 3. Build each record in an ostringstream, then copy it out with str()
+void stringStream(std::ostream& os, std::size_t records) {
+    for (std::size_t i = 0; i < records; i++) {
+        std::ostringstream oss;
+        oss << "Number: " << num << ", Pi: " << std::fixed << std::setprecision(2) << pi << '\n';
+        os << oss.str();
+    }
+}
+
+#if defined(__cpp_lib_format)
+// 5. std::format returns a fresh std::string per record
+void formatString(std::ostream& os, std::size_t records) {
+    for (std::size_t i = 0; i < records; i++) {
+        os << std::format("Number: {}, Pi: {:.2f}\n", num, pi);
+    }
+}
+#endif
+
+// 6. Same as chaining, but std::endl flushes after every record
+void withEndl(std::ostream& os, std::size_t records) {
+    os << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i < records; i++) {
+        os << "Number: " << num << ", Pi: " << pi << std::endl;
+    }
+}
+
+// 7. Labels as string_view: the length is known, no strlen per insertion
+void stringView(std::ostream& os, std::size_t records) {
+    constexpr std::string_view numberLabel = "Number: ";
+    constexpr std::string_view piLabel = ", Pi: ";
+    os << std::fixed << std::setprecision(2);
+    for (std::size_t i = 0; i < records; i++) {
+        os << numberLabel << num << piLabel << pi << '\n';
+    }
+}
+
+// 8. Appended with to_chars into the thread's reusable FormatBuffer, then
+// written in one piece: no allocation once the buffer has grown
+void formatBuffer(std::ostream& os, std::size_t records) {
+    for (std::size_t i = 0; i < records; i++) {
+        FormatBuffer& line = threadFormatBuffer();
+        line.append("Number: ").appendInt(num).append(", Pi: ").appendFixed(pi, 2).append('\n');
+        line.writeTo(os);
+    }
+}
+
+#if defined(__cpp_lib_format)
+// 9. std::format_to_n into the same reusable buffer
+void formatToBuffer(std::ostream& os, std::size_t records) {
+    for (std::size_t i = 0; i < records; i++) {
+        FormatBuffer& line = threadFormatBuffer();
+        line.format("Number: {}, Pi: {:.2f}\n", num, pi);
+        line.writeTo(os);
+    }
+}
+#endif
+
+// 4. printf goes through C stdio rather than a stream
+void classicPrintf(std::FILE* file, std::size_t records) {
+    for (std::size_t i = 0; i < records; i++) {
+        std::fprintf(file, "Number: %d, Pi: %.2f\n", num, pi);
+    }
+}
+
+// Rows with varied values, so no two lines are the same
+std::vector<NumberRow> numberRows(std::size_t n) {
+    std::vector<NumberRow> rows(n);
+    for (std::size_t i = 0; i < n; i++) {
+        int integer = static_cast<int>(i % 2000000) - 1000000;
+        rows[i] = {integer, pi * static_cast<double>(integer) / 7.0};
+    }
+    return rows;
+}
+
+// The table as demonstrateModernIO prints it: flip the manipulators for
+// every row, then reset them
+void manipulatorTable(std::ostream& os, const std::vector<NumberRow>& rows) {
+    for (const NumberRow& row : rows) {
+        os << "   Hex: " << std::hex << std::showbase << row.integer << '\n';
+        os << "   Decimal: " << std::dec << row.integer << '\n';
+        os << "   Fixed precision: " << std::fixed << std::setprecision(2) << row.real << '\n';
+        os << "   Scientific: " << std::scientific << row.real << '\n';
+        os << std::defaultfloat << std::setprecision(6);
+    }
+}
+
+std::FILE* openOrThrow(const char* path) {
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        throw std::runtime_error(std::string("cannot open ") + path);
+    }
+    return file;
+}
+
+struct StreamStrategy {
+    const char* name;
+    void (*write)(std::ostream&, std::size_t);
+};
+
+constexpr StreamStrategy kStreamStrategies[] = {
+    {"cout chaining", coutChaining},
+    {"manipulators", manipulators},
+    {"ostringstream", stringStream},
+#if defined(__cpp_lib_format)
+    {"std::format", formatString},
+#endif
+    {"std::endl per record", withEndl},
+    {"string_view labels", stringView},
+    {"format buffer", formatBuffer},
+#if defined(__cpp_lib_format)
+    {"format_to buffer", formatToBuffer},
+#endif
+};
+
+}
+
+namespace bench {
+
+void runIoBenchmarks(const Config& config, Reporter& reporter) {
+    reporter.section("I/O strategies from demonstrateModernIO");
+    const std::filesystem::path filePath = std::filesystem::path(config.outputDir) / "bench_io.out";
+    const std::string file = filePath.string();
+    const std::size_t n = config.records;
+
+    // The file run comes first: its size is also the byte count of the
+    // /dev/null run, which cannot be measured there
+    for (const StreamStrategy& strategy : kStreamStrategies) {
+        Result toFile = measure(strategy.name, "file", n, [&] {
+            std::ofstream os(file, std::ios::binary | std::ios::trunc);
+            if (!os) {
+                throw std::runtime_error("cannot open " + file);
+            }
+            strategy.write(os, n);
+            os.close();
+            return std::filesystem::file_size(filePath);
+        });
+        reporter.add(toFile);
+
+        Result toNull = measure(strategy.name, "/dev/null", n, [&] {
+            std::ofstream os("/dev/null", std::ios::binary);
+            strategy.write(os, n);
+        });
+        toNull.bytes = toFile.bytes;
+        reporter.add(toNull);
+    }
+
+    Result toFile = measure("printf", "file", n, [&] {
+        std::FILE* out = openOrThrow(file.c_str());
+        classicPrintf(out, n);
+        std::fclose(out);
+        return std::filesystem::file_size(filePath);
+    });
+    reporter.add(toFile);
+
+    Result toNull = measure("printf", "/dev/null", n, [&] {
+        std::FILE* out = openOrThrow("/dev/null");
+        classicPrintf(out, n);
+        std::fclose(out);
+    });
+    toNull.bytes = toFile.bytes;
+    reporter.add(toNull);
+
+    std::filesystem::remove(filePath);
+
+    reporter.section("Number table from demonstrateModernIO (items = rows)");
+    const std::vector<NumberRow> rows = numberRows(n);
+    {
+        // Both versions must print the same text
+        std::vector<NumberRow> sample(rows.begin(), rows.begin() + std::min<std::size_t>(n, 1000));
+        std::ostringstream expected;
+        manipulatorTable(expected, sample);
+        FormatBuffer table;
+        appendNumberTable(table, sample);
+        if (table.view() != expected.str()) {
+            throw std::runtime_error("appendNumberTable differs from the manipulator output");
+        }
+    }
+    Result manipulated = measure("manipulators", "/dev/null", n, [&] {
+        std::ofstream os("/dev/null", std::ios::binary);
+        manipulatorTable(os, rows);
+    });
+    FormatBuffer table;
+    // A new buffer every run; the next row keeps the grown one
+    Result rendered = measure("to_chars, one write", "/dev/null", n, [&] { table = FormatBuffer(); }, [&] {
+        std::ofstream os("/dev/null", std::ios::binary);
+        table.clear();
+        appendNumberTable(table, rows);
+        table.writeTo(os);
+        return table.size();
+    });
+    manipulated.bytes = rendered.bytes;
+    reporter.add(manipulated);
+    reporter.add(rendered);
+    // Again with the buffer already grown, as when a report is printed repeatedly
+    reporter.add(measure("to_chars, one write", "reused buffer", n, [&] {
+        std::ofstream os("/dev/null", std::ios::binary);
+        table.clear();
+        appendNumberTable(table, rows);
+        table.writeTo(os);
+        return table.size();
+    }));
+}
+
+}
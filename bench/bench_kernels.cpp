@@ -0,0 +1,90 @@
+// The demonstrateStl algorithms over int32 arrays: std::transform, std::find
+// and std::sort against the kernels, with every instruction set this CPU
+// supports. bytes = data read (and written, for the transform).
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "kernels.h"
+#include "bench.h"
+
+namespace {
+
+constexpr kernels::Isa kIsas[] = {
+    kernels::Isa::Scalar, kernels::Isa::Sse42, kernels::Isa::Avx2, kernels::Isa::Neon,
+};
+
+std::vector<std::int32_t> randomInts(std::size_t n) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<std::int32_t> anyInt;
+    std::vector<std::int32_t> values(n);
+    for (std::int32_t& value : values) {
+        value = anyInt(random);
+    }
+    return values;
+}
+
+}
+
+namespace bench {
+
+void runKernelBenchmarks(const Config& config, Reporter& reporter) {
+    const std::size_t n = config.records;
+    const std::size_t bytes = n * sizeof(std::int32_t);
+    std::vector<std::int32_t> input = randomInts(n);
+    std::vector<std::int32_t> output(n);
+
+    reporter.section("Doubling transform (items = ints)");
+    reporter.add(measure("transform", "std::transform", n, [&] {
+        std::transform(input.begin(), input.end(), output.begin(), [](std::int32_t x) {
+            return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) * 2u);
+        });
+        return 2 * bytes;
+    }));
+    doNotOptimize(output);
+    for (kernels::Isa isa : kIsas) {
+        if (kernels::isSupported(isa)) {
+            reporter.add(measure("transform", kernels::isaName(isa), n, [&] {
+                kernels::doubleValues(isa, input, output);
+                return 2 * bytes;
+            }));
+            doNotOptimize(output);
+        }
+    }
+
+    // A needle that is not there: every element is compared
+    reporter.section("Linear find, absent value (items = ints)");
+    input.erase(std::remove(input.begin(), input.end(), -1), input.end());
+    input.resize(n, 0);
+    std::size_t position = 0;
+    reporter.add(measure("find", "std::find", n, [&] {
+        position = static_cast<std::size_t>(std::find(input.begin(), input.end(), -1) - input.begin());
+        return bytes;
+    }));
+    doNotOptimize(position);
+    for (kernels::Isa isa : kIsas) {
+        if (kernels::isSupported(isa)) {
+            reporter.add(measure("find", kernels::isaName(isa), n, [&] {
+                position = kernels::findValue(isa, input, -1);
+                return bytes;
+            }));
+            doNotOptimize(position);
+        }
+    }
+
+    reporter.section("Sort random ints (items = ints)");
+    reporter.add(measure("sort", "std::sort", n, [&] { output = input; }, [&] {
+        std::sort(output.begin(), output.end());
+        return bytes;
+    }));
+    reporter.add(measure("sort", "radix", n, [&] { output = input; }, [&] {
+        kernels::sortValues(output);
+        return bytes;
+    }));
+    doNotOptimize(output);
+}
+
+}
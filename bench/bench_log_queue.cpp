@@ -0,0 +1,87 @@
+// Person lifecycle logging from 1 to 64 threads at once: every thread
+// creates and destroys Persons, and each one logs "Person created" and
+// "Person destroyed". Either every line goes straight to one shared stream
+// behind a mutex (what threads writing to std::cout amount to), or through
+// a LogQueue with each back-pressure policy. Timings include draining the
+// queue to the stream, and the stream is /dev/null.
+
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log_queue.h"
+#include "person.h"
+#include "bench.h"
+
+namespace {
+
+std::mutex streamMutex;
+std::ostream* lockedStream = nullptr;
+
+// One lock per line, held while the line is formatted and written
+struct LockedLogging {
+    static void write(std::string_view prefix, std::string_view text) {
+        std::lock_guard<std::mutex> lock(streamMutex);
+        *lockedStream << prefix << text << '\n';
+    }
+    static void personCreated(const std::string& name) { write("Person created: ", name); }
+    static void personDestroyed(const std::string& name) { write("Person destroyed: ", name); }
+    static void employeeCreated(std::string_view company) { write("Employee created at ", company); }
+};
+
+// `persons` Persons in total, split over `threads` threads
+template <typename Logging>
+void lifecycles(std::size_t persons, unsigned threads) {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        std::size_t count = persons / threads + (t < persons % threads ? 1 : 0);
+        workers.emplace_back([count, t] {
+            std::string name = "Worker " + std::to_string(t);
+            for (std::size_t i = 0; i < count; i++) {
+                BasicPerson<Logging> person(name, 30);
+                bench::doNotOptimize(person);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+}
+
+namespace bench {
+
+void runLogQueueBenchmarks(const Config& config, Reporter& reporter) {
+    const std::size_t persons = config.records / 2;
+    const std::size_t lines = persons * 2;
+    for (unsigned threads : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+        reporter.section("Person logging from " + std::to_string(threads) + " threads (items = lines)");
+
+        std::ofstream locked("/dev/null", std::ios::binary);
+        lockedStream = &locked;
+        reporter.add(measure("mutex + ostream", "/dev/null", lines, [&] {
+            lifecycles<LockedLogging>(persons, threads);
+            locked.flush();
+        }));
+
+        for (BackPressure policy : {BackPressure::Block, BackPressure::Drop, BackPressure::Spill}) {
+            std::ofstream sink("/dev/null", std::ios::binary);
+            LogQueue queue(sink, policy);
+            ScopedLogQueue scope(queue);
+            reporter.add(measure("log queue", backPressureName(policy), lines, [&] {
+                lifecycles<QueuedLogging>(persons, threads);
+                queue.flush();
+            }));
+            if (queue.dropped() > 0 || queue.spilled() > 0) {
+                reporter.note(std::string(backPressureName(policy)) + ": " + std::to_string(queue.dropped())
+                              + " dropped, " + std::to_string(queue.spilled()) + " spilled");
+            }
+        }
+    }
+}
+
+}
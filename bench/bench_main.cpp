@@ -0,0 +1,220 @@
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "instrumentation.h"
+#include "bench.h"
+
+namespace bench {
+
+void Reporter::begin(std::string_view suite, std::size_t records) {
+    suite_ = suite;
+    records_ = records;
+}
+
+void Reporter::section(std::string_view title) {
+    section_ = title;
+    os_ << "\n----- " << title << " -----\n"
+        << std::left << std::setw(30) << "benchmark" << std::setw(16) << "variant"
+        << std::right << std::setw(12) << "ns/item" << std::setw(12) << "MB/s"
+        << std::setw(14) << "allocs/item" << '\n';
+}
+
+void Reporter::add(const Result& result) {
+    entries_.push_back(Entry{suite_, records_ != 0 ? records_ : result.items, section_, result});
+    os_ << std::left << std::setw(30) << result.name << std::setw(16) << result.variant
+        << std::right << std::fixed << std::setprecision(2)
+        << std::setw(12) << result.nsPerItem();
+    if (result.bytes > 0) {
+        os_ << std::setw(12) << result.bytesPerSecond() / 1e6;
+    } else {
+        os_ << std::setw(12) << "-";
+    }
+    os_ << std::setw(14) << result.allocationsPerItem() << '\n' << std::flush;
+}
+
+void Reporter::note(std::string_view text) {
+    os_ << "  " << text << '\n' << std::flush;
+}
+
+void Reporter::writeJson(std::ostream& os) const {
+    using instrumentation::writeJsonString;
+    os << std::setprecision(10) << "{\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < entries_.size(); i++) {
+        const Entry& e = entries_[i];
+        os << (i == 0 ? "\n" : ",\n") << "    {\"suite\": ";
+        writeJsonString(os, e.suite);
+        os << ", \"records\": " << e.records << ", \"section\": ";
+        writeJsonString(os, e.section);
+        os << ", \"name\": ";
+        writeJsonString(os, e.result.name);
+        os << ", \"variant\": ";
+        writeJsonString(os, e.result.variant);
+        os << ", \"items\": " << e.result.items << ", \"repetitions\": " << e.result.repetitions
+           << ", \"seconds\": " << std::scientific << e.result.seconds
+           << std::defaultfloat << ", \"ns_per_item\": " << e.result.nsPerItem()
+           << ", \"bytes_per_second\": " << e.result.bytesPerSecond()
+           << ", \"allocations_per_item\": " << e.result.allocationsPerItem() << '}';
+    }
+    os << "\n  ]\n}\n";
+}
+
+}
+
+namespace {
+
+struct Suite {
+    std::string_view name;
+    void (*run)(const bench::Config&, bench::Reporter&);
+    bool fixedSize = false;   // Ignores --records: runs once, for the first size
+};
+
+// Every benchmark suite, in the order they run
+constexpr Suite kSuites[] = {
+    {"io", bench::runIoBenchmarks},
+    {"parse", bench::runParseBenchmarks},
+    {"person", bench::runPersonBenchmarks},
+    {"table", bench::runTableBenchmarks},
+    {"dispatch", bench::runDispatchBenchmarks},
+    {"alloc", bench::runAllocBenchmarks},
+    {"kernels", bench::runKernelBenchmarks},
+    {"map", bench::runMapBenchmarks, true},
+    {"pipeline", bench::runPipelineBenchmarks, true},
+    {"errors", bench::runErrorBenchmarks},
+    {"logqueue", bench::runLogQueueBenchmarks},
+    {"async", bench::runAsyncBenchmarks},
+    {"pool", bench::runPoolBenchmarks},
+    {"utf", bench::runUtfBenchmarks},
+    {"tutorial", bench::runTutorialBenchmarks, true},
+    {"startup", bench::runStartupBenchmarks},
+};
+
+std::size_t parseCount(std::string_view flag, std::string_view text) {
+    std::size_t value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size() || value == 0) {
+        throw std::invalid_argument(std::string(flag) + ": invalid count '" + std::string(text) + "'");
+    }
+    return value;
+}
+
+// "1000,1000000" -> {1000, 1000000}
+std::vector<std::size_t> parseCounts(std::string_view flag, std::string_view text) {
+    std::vector<std::size_t> counts;
+    for (;;) {
+        std::size_t comma = text.find(',');
+        counts.push_back(parseCount(flag, text.substr(0, comma)));
+        if (comma == std::string_view::npos) {
+            return counts;
+        }
+        text.remove_prefix(comma + 1);
+    }
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --suite NAME        Run only this suite (repeatable)\n"
+              << "  --records N[,N...]  Items per measurement (default 1000000); with a\n"
+              << "                      list every suite runs once per size (map, pipeline\n"
+              << "                      and tutorial have fixed sizes and run once)\n"
+              << "  --json FILE         Also write every result to FILE as JSON\n"
+              << "  --output-dir DIR    Directory for file-backed targets (default .)\n"
+              << "  --large             Also run the largest sizes (needs many GB of memory)\n"
+              << "  --list              List the suites and exit\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    bench::Config config;
+    std::vector<std::size_t> sizes{config.records};
+    std::string jsonPath;
+    std::vector<std::string_view> selected;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string_view arg = argv[i];
+            auto value = [&]() -> std::string_view {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(std::string(arg) + " requires a value");
+                }
+                return argv[++i];
+            };
+            if (arg == "--suite") {
+                selected.push_back(value());
+            } else if (arg == "--records") {
+                sizes = parseCounts(arg, value());
+            } else if (arg == "--json") {
+                jsonPath = value();
+            } else if (arg == "--output-dir") {
+                config.outputDir = value();
+            } else if (arg == "--large") {
+                config.large = true;
+            } else if (arg == "--list") {
+                for (const Suite& suite : kSuites) {
+                    std::cout << suite.name << '\n';
+                }
+                return 0;
+            } else if (arg == "-h" || arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else {
+                throw std::invalid_argument("unknown option '" + std::string(arg) + "'");
+            }
+        }
+        for (std::string_view name : selected) {
+            bool known = false;
+            for (const Suite& suite : kSuites) {
+                known = known || suite.name == name;
+            }
+            if (!known) {
+                throw std::invalid_argument("unknown suite '" + std::string(name) + "' (see --list)");
+            }
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        printUsage(argv[0]);
+        return 1;
+    }
+
+#if !defined(__OPTIMIZE__) && (defined(__GNUC__) || defined(__clang__))
+    std::cout << "Warning: unoptimized build, configure with -DCMAKE_BUILD_TYPE=Release for real numbers\n";
+#endif
+
+    bench::Reporter reporter(std::cout);
+    for (std::size_t records : sizes) {
+        config.records = records;
+        if (sizes.size() > 1) {
+            std::cout << "\n===== records = " << records << " =====\n";
+        }
+        for (const Suite& suite : kSuites) {
+            bool wanted = selected.empty();
+            for (std::string_view name : selected) {
+                wanted = wanted || name == suite.name;
+            }
+            if (!wanted || (suite.fixedSize && records != sizes.front())) {
+                continue;
+            }
+            try {
+                reporter.begin(suite.name, suite.fixedSize ? 0 : records);
+                suite.run(config, reporter);
+            } catch (const std::exception& e) {
+                std::cerr << "Error in suite " << suite.name << ": " << e.what() << '\n';
+                return 1;
+            }
+        }
+    }
+    if (!jsonPath.empty()) {
+        std::ofstream json(jsonPath);
+        reporter.writeJson(json);
+        if (!json) {
+            std::cerr << "Error: cannot write " << jsonPath << '\n';
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,166 @@
+// The demonstrateStl "ages" table with many keys: insert, lookup (every
+// key, in random order) and ordered iteration for FlatHashMap,
+// SortedVectorMap and std::map. Sizes are fixed (1K and 1M keys, 50M with
+// --large) rather than taken from --records.
+// Then the statistics a dashboard polls over the same table (count, sum,
+// youngest, oldest, histogram): a rescan per poll versus AgeStatsMap,
+// which pays for them on every change instead.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "age_stats.h"
+#include "flat_map.h"
+#include "person.h"
+#include "bench.h"
+
+namespace {
+
+// "person-<n>": short enough for the small string buffer, so the keys
+// themselves do not allocate and only the containers are compared
+std::vector<std::string> makeKeys(std::size_t n) {
+    std::vector<std::string> keys;
+    keys.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        keys.push_back("person-" + std::to_string(i));
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(3));
+    return keys;
+}
+
+template <typename Map>
+void runMap(bench::Reporter& reporter, const char* variant, const std::vector<std::string>& keys,
+            const std::vector<std::string_view>& lookups) {
+    const std::size_t n = keys.size();
+    Map map;
+    if constexpr (requires { map.insertBulk(std::vector<std::pair<std::string_view, int>>{}); }) {
+        // One insert() at a time would be O(n^2) here
+        reporter.add(bench::measure("insert (bulk)", variant, n, [&] { map = Map(); }, [&] {
+            std::vector<std::pair<std::string_view, int>> items;
+            items.reserve(n);
+            for (std::size_t i = 0; i < n; i++) {
+                items.emplace_back(keys[i], static_cast<int>(i));
+            }
+            map.insertBulk(items);
+        }));
+    } else {
+        reporter.add(bench::measure("insert", variant, n, [&] { map = Map(); }, [&] {
+            for (std::size_t i = 0; i < n; i++) {
+                map.insert(keys[i], static_cast<int>(i));
+            }
+        }));
+    }
+
+    long long sum = 0;
+    reporter.add(bench::measure("lookup", variant, n, [&] {
+        for (std::string_view key : lookups) {
+            if (const int* value = map.find(key)) {
+                sum += *value;
+            }
+        }
+    }));
+    reporter.add(bench::measure("ordered iteration", variant, n, [&] {
+        map.forEachOrdered([&sum](std::string_view key, int value) { sum += value + static_cast<long long>(key.size()); });
+    }));
+    bench::doNotOptimize(sum);
+}
+
+using QuietPerson = BasicPerson<NoLogging>;
+
+int ageFor(std::size_t i) {
+    return 18 + static_cast<int>((i * 7) % 60);
+}
+
+void runAgeStats(bench::Reporter& reporter, const std::vector<std::string>& keys) {
+    const std::size_t n = keys.size();
+    FlatHashMap<QuietPerson> plain;
+    AgeStatsMap<QuietPerson> tracked;
+    auto emptyPlain = [&] {
+        plain = FlatHashMap<QuietPerson>();
+        plain.reserve(n);
+    };
+    auto emptyTracked = [&] {
+        tracked.clear();
+        tracked.reserve(n);
+    };
+    reporter.add(bench::measure("insert", "FlatHashMap", n, emptyPlain, [&] {
+        for (std::size_t i = 0; i < n; i++) {
+            plain.insert(keys[i], QuietPerson(keys[i], ageFor(i)));
+        }
+    }));
+    reporter.add(bench::measure("insert", "AgeStatsMap", n, emptyTracked, [&] {
+        for (std::size_t i = 0; i < n; i++) {
+            tracked.insert(keys[i], QuietPerson(keys[i], ageFor(i)));
+        }
+    }));
+    // Alternates between two ages, so every run really changes each one
+    std::size_t shift = 1;
+    auto nextShift = [&shift] { shift = 3 - shift; };
+    reporter.add(bench::measure("setAge by key", "FlatHashMap", n, nextShift, [&] {
+        for (std::size_t i = 0; i < n; i++) {
+            plain.find(keys[i])->setAge(ageFor(i + shift));
+        }
+    }));
+    reporter.add(bench::measure("setAge by key", "AgeStatsMap", n, nextShift, [&] {
+        for (std::size_t i = 0; i < n; i++) {
+            tracked.setAge(keys[i], ageFor(i + shift));
+        }
+    }));
+    // The two may have run a different number of times
+    for (std::string_view key : keys) {
+        plain.find(key)->setAge(tracked.find(key)->getAge());
+    }
+
+    // One poll reads every statistic once; items = polls (far more of the
+    // cheap ones, so the clock can see them)
+    constexpr std::size_t kRescans = 16;
+    constexpr std::size_t kPolls = 1'000'000;
+    long long checksum = 0;
+    AgeStats rescanned;
+    reporter.add(bench::measure("poll statistics", "rescan", kRescans, [&] {
+        for (std::size_t poll = 0; poll < kRescans; poll++) {
+            rescanned = AgeStats();
+            plain.forEach([&rescanned](std::string_view, const QuietPerson& person) { rescanned.add(person.getAge()); });
+            checksum += rescanned.sum() + rescanned.min() + rescanned.max() + rescanned.histogram().begin()->second;
+        }
+    }));
+    reporter.add(bench::measure("poll statistics", "AgeStatsMap", kPolls, [&] {
+        for (std::size_t poll = 0; poll < kPolls; poll++) {
+            const AgeStats& stats = tracked.stats();
+            checksum += stats.sum() + stats.min() + stats.max() + stats.histogram().begin()->second;
+        }
+    }));
+    bench::doNotOptimize(checksum);
+    if (tracked.stats() != rescanned || tracked.stats() != tracked.rescan()) {
+        reporter.note("the tracked statistics differ from a rescan");
+    }
+}
+
+}
+
+namespace bench {
+
+void runMapBenchmarks(const Config& config, Reporter& reporter) {
+    std::vector<std::size_t> sizes = {1'000, 1'000'000};
+    if (config.large) {
+        sizes.push_back(50'000'000);
+    }
+    for (std::size_t n : sizes) {
+        reporter.section("String-keyed map, " + std::to_string(n) + " keys (items = keys)");
+        std::vector<std::string> keys = makeKeys(n);
+        std::vector<std::string_view> lookups(keys.begin(), keys.end());
+        std::shuffle(lookups.begin(), lookups.end(), std::mt19937(4));
+        runMap<FlatHashMap<int>>(reporter, "flat hash", keys, lookups);
+        runMap<SortedVectorMap<int>>(reporter, "sorted vector", keys, lookups);
+        runMap<StdMap<int>>(reporter, "std::map", keys, lookups);
+    }
+    for (std::size_t n : sizes) {
+        reporter.section("Polled age statistics, " + std::to_string(n) + " people (items = people, or polls)");
+        runAgeStats(reporter, makeKeys(n));
+    }
+}
+
+}
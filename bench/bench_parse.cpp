@@ -0,0 +1,139 @@
+// Compares the parsing approaches from demonstrateModernIO on a large
+// input made of "123 3.14 Hello"-style records: std::istringstream,
+// std::stoi/std::stod on split tokens, and the <charconv> Tokenizer, then
+// the Tokenizer split into chunks on the thread pool (parallel_parse.h).
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "fast_parse.h"
+#include "parallel_parse.h"
+#include "bench.h"
+
+namespace {
+
+// Builds `records` lines of "<int> <double> <word>"
+std::string makeInput(std::size_t records) {
+    static constexpr std::string_view kWords[] = {"Hello", "World", "C++", "charconv"};
+    std::string input;
+    input.reserve(records * 24);
+    for (std::size_t i = 0; i < records; i++) {
+        input += std::to_string(static_cast<int>(i % 100000));
+        input += ' ';
+        input += std::to_string(static_cast<double>(i % 1000) + 0.25);
+        input += ' ';
+        input += kWords[i % 4];
+        input += '\n';
+    }
+    return input;
+}
+
+ParseSummary parseWithStringStream(const std::string& input) {
+    ParseSummary summary;
+    std::istringstream iss(input);
+    int parsedInt;
+    double parsedDouble;
+    std::string parsedString;
+    while (iss >> parsedInt >> parsedDouble >> parsedString) {
+        summary.ints++;
+        summary.intSum += parsedInt;
+        summary.doubles++;
+        summary.doubleSum += parsedDouble;
+        summary.words++;
+    }
+    return summary;
+}
+
+// Split into std::string tokens first (the usual companion of stoi)
+ParseSummary parseWithStoi(const std::string& input) {
+    ParseSummary summary;
+    std::size_t field = 0;
+    std::size_t pos = 0;
+    while (pos < input.size()) {
+        while (pos < input.size() && isSpace(input[pos])) {
+            pos++;
+        }
+        std::size_t start = pos;
+        while (pos < input.size() && !isSpace(input[pos])) {
+            pos++;
+        }
+        if (start == pos) {
+            break;
+        }
+        std::string token = input.substr(start, pos - start);
+        switch (field++ % 3) {
+            case 0:
+                summary.ints++;
+                summary.intSum += std::stoi(token);
+                break;
+            case 1:
+                summary.doubles++;
+                summary.doubleSum += std::stod(token);
+                break;
+            default:
+                summary.words++;
+                break;
+        }
+    }
+    return summary;
+}
+
+}
+
+namespace bench {
+
+void runParseBenchmarks(const Config& config, Reporter& reporter) {
+    const std::string input = makeInput(config.records);
+    const std::size_t tokens = config.records * 3;
+    reporter.section("Parsing " + std::to_string(input.size() / (1024 * 1024)) + " MiB (items = tokens)");
+
+    auto run = [&](const char* name, auto parse) {
+        ParseSummary summary;
+        Result result = measure(name, "in memory", tokens, [&] {
+            summary = parse(input);
+            return input.size();
+        });
+        doNotOptimize(summary);
+        reporter.add(result);
+        if (summary.tokens() != tokens) {
+            throw std::runtime_error(std::string(name) + " parsed the wrong number of tokens");
+        }
+    };
+
+    run("istringstream >>", parseWithStringStream);
+    run("split + stoi/stod", parseWithStoi);
+    run("Tokenizer (from_chars)", [](const std::string& s) { return summarize(s); });
+
+    // The --mmap parse on 1, 2, 4, ... threads up to every hardware thread
+    reporter.section("Parallel chunked parse (items = tokens)");
+    const ParseSummary serial = summarize(input);
+    const unsigned maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        ThreadPool pool(threads);
+        ParseSummary summary;
+        const std::string variant = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        Result result = measure("summarizeParallel", variant, tokens, [&] {
+            summary = summarizeParallel(pool, input);
+            return input.size();
+        });
+        reporter.add(result);
+        if (summary.tokens() != serial.tokens() || summary.intSum != serial.intSum
+            || summary.intSumWraps != serial.intSumWraps
+            || summary.doubleSum != serial.doubleSum) {
+            throw std::runtime_error("summarizeParallel differs from the serial parse");
+        }
+        char gigabytes[64];
+        std::snprintf(gigabytes, sizeof(gigabytes), "%.2f GB/s", result.bytesPerSecond() / 1e9);
+        reporter.note(variant + ": " + gigabytes);
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+}
+
+}
@@ -0,0 +1,133 @@
+// Compares the ways demonstrateClasses creates a Person (raw new,
+// make_shared, make_unique) with the PersonPool arena, for a whole
+// population: construction, one traversal summing the ages, and teardown.
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "person_pool.h"
+#include "bench.h"
+
+namespace {
+
+using QuietPerson = BasicPerson<NoLogging>;
+
+const std::string kNames[] = {"Alice", "Bob", "Charlie", "Dave", "Eve", "Mallory", "Trent", "Peggy"};
+
+const std::string& nameFor(std::size_t i) {
+    return kNames[i % (sizeof(kNames) / sizeof(kNames[0]))];
+}
+
+int ageFor(std::size_t i) {
+    return 18 + static_cast<int>(i % 60);
+}
+
+// Runs construct / traverse / teardown for one storage strategy. Each
+// repetition of one starts from the state the other leaves behind.
+template <typename Construct, typename Traverse, typename Teardown>
+void runStrategy(bench::Reporter& reporter, const char* strategy, std::size_t n,
+                 Construct construct, Traverse traverse, Teardown teardown) {
+    reporter.add(bench::measure("construct", strategy, n, teardown, construct));
+    long long total = 0;
+    reporter.add(bench::measure("traverse", strategy, n, [&] { total = traverse(); }));
+    bench::doNotOptimize(total);
+    reporter.add(bench::measure("teardown", strategy, n, [&] { teardown(); construct(); }, teardown));
+}
+
+}
+
+namespace bench {
+
+void runPersonBenchmarks(const Config& config, Reporter& reporter) {
+    const std::size_t n = config.records;
+    reporter.section("Person storage: arena vs heap (items = people)");
+
+    {
+        PersonPool<> pool;
+        runStrategy(reporter, "PersonPool", n,
+            [&] {
+                for (std::size_t i = 0; i < n; i++) {
+                    pool.addPerson(nameFor(i), ageFor(i));
+                }
+            },
+            [&] {
+                long long total = 0;
+                pool.forEachPerson([&total](const QuietPerson& p) { total += p.getAge(); });
+                return total;
+            },
+            [&] { pool.release(); });
+    }
+
+    {
+        std::vector<QuietPerson*> people;
+        runStrategy(reporter, "new/delete", n,
+            [&] {
+                people.reserve(n);
+                for (std::size_t i = 0; i < n; i++) {
+                    people.push_back(new QuietPerson(nameFor(i), ageFor(i)));
+                }
+            },
+            [&] {
+                long long total = 0;
+                for (const QuietPerson* p : people) {
+                    total += p->getAge();
+                }
+                return total;
+            },
+            [&] {
+                for (QuietPerson* p : people) {
+                    delete p;
+                }
+                people.clear();
+                people.shrink_to_fit();
+            });
+    }
+
+    {
+        std::vector<std::shared_ptr<QuietPerson>> people;
+        runStrategy(reporter, "make_shared", n,
+            [&] {
+                people.reserve(n);
+                for (std::size_t i = 0; i < n; i++) {
+                    people.push_back(std::make_shared<QuietPerson>(nameFor(i), ageFor(i)));
+                }
+            },
+            [&] {
+                long long total = 0;
+                for (const auto& p : people) {
+                    total += p->getAge();
+                }
+                return total;
+            },
+            [&] {
+                people.clear();
+                people.shrink_to_fit();
+            });
+    }
+
+    {
+        std::vector<std::unique_ptr<QuietPerson>> people;
+        runStrategy(reporter, "make_unique", n,
+            [&] {
+                people.reserve(n);
+                for (std::size_t i = 0; i < n; i++) {
+                    people.push_back(std::make_unique<QuietPerson>(nameFor(i), ageFor(i)));
+                }
+            },
+            [&] {
+                long long total = 0;
+                for (const auto& p : people) {
+                    total += p->getAge();
+                }
+                return total;
+            },
+            [&] {
+                people.clear();
+                people.shrink_to_fit();
+            });
+    }
+}
+
+}
@@ -0,0 +1,154 @@
+// The work-stealing ThreadPool on the demonstrateStl workloads, on 1, 2, 4,
+// ... threads up to every hardware thread: the doubling transform and the
+// sort written as fork/join (split in halves down to a grain size, one half
+// submitted, the other run in place), plus what scheduling itself costs
+// per task. With --records 1000 most of the work is below one grain.
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+#include "bench.h"
+
+namespace {
+
+constexpr std::size_t kGrain = 16 * 1024;
+
+std::int32_t doubled(std::int32_t x) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) * 2u);
+}
+
+void doubleValues(ThreadPool& pool, std::span<const std::int32_t> in, std::span<std::int32_t> out) {
+    if (in.size() <= kGrain) {
+        std::transform(in.begin(), in.end(), out.begin(), doubled);
+        return;
+    }
+    const std::size_t half = in.size() / 2;
+    PoolTask<void> left = pool.submit([&pool, in, out, half] {
+        doubleValues(pool, in.first(half), out.first(half));
+    });
+    doubleValues(pool, in.subspan(half), out.subspan(half));
+    left.get();
+}
+
+// Merge sort: the halves in parallel, then an in-place merge
+void sortValues(ThreadPool& pool, std::span<std::int32_t> values) {
+    if (values.size() <= 4 * kGrain) {
+        std::sort(values.begin(), values.end());
+        return;
+    }
+    const std::size_t half = values.size() / 2;
+    PoolTask<void> left = pool.submit([&pool, values, half] { sortValues(pool, values.first(half)); });
+    sortValues(pool, values.subspan(half));
+    left.get();
+    std::inplace_merge(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(half), values.end());
+}
+
+// A binary tree of empty tasks with `count` leaves, spawned from inside the pool
+void spawnTree(ThreadPool& pool, std::size_t count) {
+    if (count <= 1) {
+        return;
+    }
+    PoolTask<void> left = pool.submit([&pool, count] { spawnTree(pool, count / 2); });
+    spawnTree(pool, count - count / 2);
+    left.get();
+}
+
+std::string threadLabel(unsigned threads) {
+    return std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+}
+
+}
+
+namespace bench {
+
+void runPoolBenchmarks(const Config& config, Reporter& reporter) {
+    const std::size_t n = config.records;
+    std::vector<std::int32_t> input(n);
+    std::mt19937 random(5);
+    std::uniform_int_distribution<std::int32_t> anyInt;
+    for (std::int32_t& value : input) {
+        value = anyInt(random);
+    }
+    std::vector<std::int32_t> sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<std::int32_t> output(n);
+    const std::size_t bytes = n * sizeof(std::int32_t);
+
+    const unsigned maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    reporter.section("Work-stealing pool, fork/join demonstrateStl workloads (items = ints)");
+    reporter.add(measure("transform", "std::transform", n, [&] {
+        std::transform(input.begin(), input.end(), output.begin(), doubled);
+        return 2 * bytes;
+    }));
+    std::vector<std::int32_t> values;
+    reporter.add(measure("sort", "std::sort", n, [&] { values = input; }, [&] {
+        std::sort(values.begin(), values.end());
+        return bytes;
+    }));
+    struct Placement {
+        Pinning pinning;
+        const char* suffix;
+    };
+    const Placement placements[] = {{Pinning::None, ""}, {Pinning::Cores, ", pinned"}, {Pinning::NumaNodes, ", per node"}};
+    for (const Placement& placement : placements) {
+        for (unsigned threads : threadCounts) {
+            // Pinning only changes anything with every core in use
+            if (placement.pinning != Pinning::None && threads != maxThreads) {
+                continue;
+            }
+            ThreadPool pool(threads, placement.pinning);
+            const std::string variant = threadLabel(threads) + placement.suffix;
+            reporter.add(measure("transform", variant, n, [&] {
+                pool.submit([&] { doubleValues(pool, input, output); }).get();
+                return 2 * bytes;
+            }));
+            reporter.add(measure("sort", variant, n, [&] { values = input; }, [&] {
+                pool.submit([&] { sortValues(pool, values); }).get();
+                return bytes;
+            }));
+            if (values != sorted) {
+                reporter.note(variant + ": sort result is wrong");
+            }
+        }
+    }
+
+    reporter.section("Scheduling cost (items = tasks)");
+    for (unsigned threads : threadCounts) {
+        ThreadPool pool(threads);
+        const std::string variant = threadLabel(threads);
+        reporter.add(measure("submit + get from outside", variant, n, [&] {
+            std::vector<PoolTask<void>> tasks;
+            tasks.reserve(n);
+            for (std::size_t i = 0; i < n; i++) {
+                tasks.push_back(pool.submit([] {}));
+            }
+            for (PoolTask<void>& task : tasks) {
+                task.get();
+            }
+        }));
+        reporter.add(measure("fork/join tree in the pool", variant, n, [&] {
+            pool.submit([&] { spawnTree(pool, n); }).get();
+        }));
+        reporter.add(measure("then() chain", variant, n, [&] {
+            PoolTask<std::size_t> chain = pool.submit([] { return std::size_t{0}; });
+            for (std::size_t i = 1; i < n; i++) {
+                chain = std::move(chain).then([](std::size_t x) { return x + 1; });
+            }
+            doNotOptimize(chain.get());
+        }));
+    }
+}
+
+}
@@ -0,0 +1,180 @@
+// Aggregate queries over a roster stored as std::vector<Employee> versus
+// the columnar PersonTable: average age, count at one company, age range.
+// Then what a restarting worker pays to get its roster back: rebuilding it
+// row by row versus opening a saved snapshot (person_snapshot.h).
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "output_sink.h"
+#include "person.h"
+#include "person_snapshot.h"
+#include "person_table.h"
+#include "bench.h"
+
+namespace {
+
+using QuietEmployee = BasicEmployee<NoLogging>;
+
+const std::string kCompanies[] = {"Acme Inc", "Globex Corporation", "Initech", "Umbrella Corp"};
+const std::string kNames[] = {"Alice", "Bob", "Charlie", "Dave", "Eve", "Mallory", "Trent", "Peggy"};
+
+// Changes one character of a name in the snapshot at `path`: opening it must
+// still succeed (it does not read the pools), verifyStrings() must not
+bool damagedPoolIsCaught(const std::string& path) {
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    const std::size_t at = bytes.find(kNames[0]);
+    if (at == std::string::npos) {
+        return false;
+    }
+    bytes[at] = 'a';
+    const std::string damaged = path + ".damaged";
+    std::ofstream(damaged, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    bool caught = false;
+    try {
+        PersonSnapshot snapshot(damaged);
+        snapshot.verifyColumns();   // The columns are intact
+        try {
+            snapshot.verifyStrings();
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+    } catch (const std::runtime_error&) {
+        caught = false;   // The constructor or verifyColumns() must not notice
+    }
+    std::filesystem::remove(damaged);
+    return caught;
+}
+
+}
+
+namespace bench {
+
+void runTableBenchmarks(const Config& config, Reporter& reporter) {
+    const std::size_t n = config.records;
+    reporter.section("Roster queries: vector<Employee> vs PersonTable (items = rows)");
+
+    std::vector<QuietEmployee> roster;
+    PersonTable table;
+    roster.reserve(n);
+    table.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        const std::string& name = kNames[i % 8];
+        int age = 18 + static_cast<int>((i * 7) % 60);
+        const std::string& company = kCompanies[i % 4];
+        roster.emplace_back(name, age, company);
+        table.addEmployee(name, age, company);
+    }
+    // MB/s is the speed of the data each layout has to touch
+    const std::size_t rosterBytes = n * sizeof(QuietEmployee);
+
+    double average = 0;
+    reporter.add(measure("average age", "vector<Employee>", n, [&] {
+        long long total = 0;
+        for (const QuietEmployee& e : roster) {
+            total += e.getAge();
+        }
+        average = n ? static_cast<double>(total) / static_cast<double>(n) : 0;
+        return rosterBytes;
+    }));
+    reporter.add(measure("average age", "PersonTable", n, [&] {
+        average = table.averageAge();
+        return n * sizeof(int);
+    }));
+    doNotOptimize(average);
+
+    std::size_t count = 0;
+    reporter.add(measure("count at company", "vector<Employee>", n, [&] {
+        count = 0;
+        for (const QuietEmployee& e : roster) {
+            count += e.getCompany() == "Initech";
+        }
+        return rosterBytes;
+    }));
+    reporter.add(measure("count at company", "PersonTable", n, [&] {
+        count = table.countAtCompany("Initech");
+        return n * sizeof(PersonTable::Id);
+    }));
+    doNotOptimize(count);
+
+    reporter.add(measure("age range 30..45", "vector<Employee>", n, [&] {
+        count = 0;
+        for (const QuietEmployee& e : roster) {
+            count += e.getAge() >= 30 && e.getAge() <= 45;
+        }
+        return rosterBytes;
+    }));
+    reporter.add(measure("age range 30..45", "PersonTable", n, [&] {
+        count = table.countInAgeRange(30, 45);
+        return n * sizeof(int);
+    }));
+    doNotOptimize(count);
+
+    reporter.section("Roster startup: rebuild vs snapshot (items = rows)");
+    roster = {};
+    {
+        // The "Person created" lines of the logging constructor go nowhere
+        NullBuffer nullBuffer;
+        std::ostream nullStream(&nullBuffer);
+        ScopedOutput redirect(nullStream);
+        std::vector<Employee> employees;
+        reporter.add(measure("rebuild", "Employee objects", n, [&] { employees = {}; }, [&] {
+            employees.reserve(n);
+            for (std::size_t i = 0; i < n; i++) {
+                employees.emplace_back(kNames[i % 8], 18 + static_cast<int>((i * 7) % 60), kCompanies[i % 4]);
+            }
+        }));
+        employees = {};
+    }
+    reporter.add(measure("rebuild", "PersonTable", n, [&] {
+        PersonTable rebuilt;
+        rebuilt.reserve(n);
+        for (std::size_t i = 0; i < n; i++) {
+            rebuilt.addEmployee(kNames[i % 8], 18 + static_cast<int>((i * 7) % 60), kCompanies[i % 4]);
+        }
+        doNotOptimize(rebuilt);
+    }));
+
+    const std::string path = (std::filesystem::path(config.outputDir) / "bench_roster.snapshot").string();
+    reporter.add(measure("save snapshot", "file", n, [&] {
+        saveSnapshot(table, path);
+        return std::filesystem::file_size(path);
+    }));
+    reporter.add(measure("open snapshot", "mmap", n, [&] {
+        PersonSnapshot snapshot(path);
+        doNotOptimize(snapshot);
+    }));
+    {
+        PersonSnapshot snapshot(path);
+        reporter.add(measure("verify columns", "checksum", n, [&] {
+            snapshot.verifyColumns();
+            return n * (sizeof(int) + 2 * sizeof(PersonTable::Id));
+        }));
+        reporter.add(measure("verify strings", "checksum", n, [&] {
+            snapshot.verifyStrings();
+        }));
+        reporter.add(measure("average age", "PersonSnapshot", n, [&] {
+            average = snapshot.averageAge();
+            return n * sizeof(int);
+        }));
+        doNotOptimize(average);
+        if (average != table.averageAge() || snapshot.countAtCompany("Initech") != table.countAtCompany("Initech")) {
+            reporter.note("the snapshot answers differ from the table");
+        }
+    }
+    if (n > 0 && !damagedPoolIsCaught(path)) {
+        reporter.note("a damaged string pool went unnoticed by verifyStrings()");
+    }
+    std::filesystem::remove(path);
+}
+
+}
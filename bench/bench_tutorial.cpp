@@ -0,0 +1,192 @@
+// The tutorial binary itself (MyProject, built from the same tree), run
+// from start to finish with its output going to /dev/null. The "default"
+// row runs it without flags; the others add the flags that change how the
+// same output is produced.
+// Items are whole runs, process start-up and exit included.
+//
+// Before that, in this process: the four sections of compile_time.h
+// written live into a stream, against the texts the compiler rendered from
+// the same code for --precomputed. The two must be equal byte for byte.
+//
+// The startup suite launches it many times for a single small section,
+// the way a short-lived worker process would run: the time from spawning
+// it to having reaped it, with and without --fast-startup.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if __has_include(<spawn.h>) && __has_include(<sys/wait.h>)
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define MYPROJECT_BENCH_HAS_SPAWN 1
+#else
+#define MYPROJECT_BENCH_HAS_SPAWN 0
+#endif
+
+#include "compile_time.h"
+#include "bench.h"
+
+extern char** environ;
+
+namespace {
+
+constexpr std::size_t kRuns = 20;
+constexpr std::size_t kSectionRuns = 10'000;
+
+using compile_time::BasicSyntaxSection;
+using compile_time::ControlFlowSection;
+using compile_time::FunctionsSection;
+using compile_time::VariablesAndTypesSection;
+
+void writeSectionsLive(std::ostream& out) {
+    BasicSyntaxSection::write(out);
+    VariablesAndTypesSection::write(out);
+    ControlFlowSection::write(out);
+    FunctionsSection::write(out);
+}
+
+void writeSectionsPrecomputed(std::ostream& out) {
+    out << compile_time::basicSyntaxText << compile_time::variablesAndTypesText
+        << compile_time::controlFlowText << compile_time::functionsText;
+}
+
+template <typename Section>
+void compareSection(bench::Reporter& reporter, const char* name, std::string_view precomputed) {
+    std::ostringstream live;
+    Section::write(live);
+    if (live.str() != precomputed) {
+        reporter.note(std::string(name) + ": the --precomputed text differs from the live output");
+    }
+}
+
+#if MYPROJECT_BENCH_HAS_SPAWN && defined(MYPROJECT_TUTORIAL_PATH)
+
+// Runs the tutorial once with `args`, stdout to /dev/null; throws if it fails
+void runTutorial(const std::vector<std::string>& args) {
+    std::vector<char*> argv;
+    std::string program = MYPROJECT_TUTORIAL_PATH;
+    argv.push_back(program.data());
+    std::vector<std::string> copies = args;
+    for (std::string& arg : copies) {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    pid_t pid = 0;
+    int error = posix_spawn(&pid, program.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (error != 0) {
+        throw std::runtime_error("cannot start " + program);
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error(program + " failed");
+    }
+}
+
+// The launch time below which `fraction` of `samples` fall
+double percentile(std::vector<double> samples, double fraction) {
+    auto nth = samples.begin() + static_cast<std::ptrdiff_t>(fraction * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+#endif
+
+}
+
+namespace bench {
+
+void runTutorialBenchmarks([[maybe_unused]] const Config& config, Reporter& reporter) {
+    reporter.section("Tutorial sections, live vs compile-time text (items = four sections)");
+    compareSection<BasicSyntaxSection>(reporter, "basic-syntax", compile_time::basicSyntaxText);
+    compareSection<VariablesAndTypesSection>(reporter, "variables-and-types", compile_time::variablesAndTypesText);
+    compareSection<ControlFlowSection>(reporter, "control-flow", compile_time::controlFlowText);
+    compareSection<FunctionsSection>(reporter, "functions", compile_time::functionsText);
+    std::ostringstream out;
+    reporter.add(measure("write sections", "live", kSectionRuns, [&] {
+        for (std::size_t i = 0; i < kSectionRuns; i++) {
+            out.str({});
+            writeSectionsLive(out);
+        }
+    }));
+    reporter.add(measure("write sections", "precomputed", kSectionRuns, [&] {
+        for (std::size_t i = 0; i < kSectionRuns; i++) {
+            out.str({});
+            writeSectionsPrecomputed(out);
+        }
+    }));
+
+    reporter.section("Tutorial binary, start to finish (items = runs)");
+#if MYPROJECT_BENCH_HAS_SPAWN && defined(MYPROJECT_TUTORIAL_PATH)
+    struct Variant {
+        std::string name;
+        std::vector<std::string> args;
+    };
+    const std::vector<Variant> variants = {
+        {"default", {}},
+        {"-j 0", {"-j", "0"}},
+        {"--precomputed", {"--precomputed"}},
+        {"--stl-size " + std::to_string(config.records), {"--only", "stl", "--stl-size", std::to_string(config.records)}},
+    };
+    for (const Variant& variant : variants) {
+        reporter.add(measure("MyProject", variant.name, kRuns, [&] {
+            for (std::size_t i = 0; i < kRuns; i++) {
+                runTutorial(variant.args);
+            }
+        }));
+    }
+#else
+    reporter.note("skipped: needs posix_spawn and the path of the MyProject binary");
+#endif
+}
+
+void runStartupBenchmarks([[maybe_unused]] const Config& config, Reporter& reporter) {
+    reporter.section("Tutorial binary, exec to exit for one section (items = launches)");
+#if MYPROJECT_BENCH_HAS_SPAWN && defined(MYPROJECT_TUTORIAL_PATH)
+    // 10K launches by default; --records lowers it for a quick look
+    const std::size_t launches = std::max<std::size_t>(std::min<std::size_t>(config.records, 10'000), 1);
+    struct Variant {
+        std::string name;
+        std::vector<std::string> args;
+    };
+    const std::vector<Variant> variants = {
+        {"default", {"--only", "basic-syntax"}},
+        {"--fast-startup", {"--fast-startup", "--only", "basic-syntax"}},
+        {"+ no-stdio-sync", {"--fast-startup", "--no-stdio-sync", "--only", "basic-syntax"}},
+    };
+    runTutorial({"--only", "basic-syntax"});  // Warm the page cache
+    for (const Variant& variant : variants) {
+        std::vector<double> micros;
+        micros.reserve(launches);
+        // One run: the launches are the repetitions, summarized by the percentiles below
+        reporter.add(measureOnce("MyProject", variant.name, launches, [&] {
+            for (std::size_t i = 0; i < launches; i++) {
+                auto start = std::chrono::steady_clock::now();
+                runTutorial(variant.args);
+                micros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+            }
+        }));
+        char latency[64];
+        std::snprintf(latency, sizeof(latency), "p50 %.0f us, p99 %.0f us", percentile(micros, 0.50),
+                      percentile(micros, 0.99));
+        reporter.note(variant.name + ": " + latency);
+    }
+    reporter.note("most of a launch is loading the shared libraries: see MYPROJECT_STATIC_RUNTIME in CMakeLists.txt");
+#else
+    reporter.note("skipped: needs posix_spawn and the path of the MyProject binary");
+#endif
+}
+
+}
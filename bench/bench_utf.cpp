@@ -0,0 +1,165 @@
+// UTF-8 validation and conversion (utf.h) against std::wstring_convert
+// with the <codecvt> facets, over two generated texts of about --records
+// bytes: mostly English with a few accents, and a mix of European, Cyrillic,
+// Greek, CJK and emoji paragraphs. Items are bytes of UTF-8. Every
+// conversion includes allocating and filling the output string, which is
+// much of what is left once the characters themselves are cheap.
+
+#include <codecvt>
+#include <cstddef>
+#include <locale>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kernels.h"
+#include "utf.h"
+#include "bench.h"
+
+// wstring_convert and <codecvt> are deprecated since C++17; they are the baseline here
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+namespace {
+
+constexpr kernels::Isa kIsas[] = {
+    kernels::Isa::Scalar, kernels::Isa::Sse42, kernels::Isa::Avx2, kernels::Isa::Neon,
+};
+
+const std::vector<std::string_view> kEnglish = {
+    "The quick brown fox jumps over the lazy dog. ",
+    "Meet me at the café at noon, then we will review the résumés. ",
+    "Shipping to 1234 Main Street takes three to five business days.\n",
+};
+
+const std::vector<std::string_view> kMultilingual = {
+    "The quick brown fox jumps over the lazy dog. ",
+    "Grüße aus Köln, schöne Straßen und Äpfel. ",
+    "Съешь же ещё этих мягких французских булок. ",
+    "Ξεσκεπάζω την ψυχοφθόρα βδελυγμία. ",
+    "今日はいい天気ですね。我们明天见。 ",
+    "\U0001F600 \U0001F680 \U0001F30D\n",
+};
+
+// Sample lines repeated until the text has at least `bytes` bytes
+std::string makeText(const std::vector<std::string_view>& samples, std::size_t bytes) {
+    std::string text;
+    text.reserve(bytes + 256);
+    for (std::size_t i = 0; text.size() < bytes; i++) {
+        text += samples[i % samples.size()];
+    }
+    return text;
+}
+
+void runText(bench::Reporter& reporter, const std::string& text) {
+    using bench::measure;
+    const std::size_t n = text.size();
+    std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> utf16Convert;
+    std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t> utf32Convert;
+
+    // codecvt::length() walks the text without converting it
+    const std::codecvt_utf8<char32_t> facet;
+    reporter.add(measure("validate", "codecvt length", n, [&] {
+        std::mbstate_t state{};
+        std::size_t length = static_cast<std::size_t>(facet.length(state, text.data(), text.data() + n, n));
+        bench::doNotOptimize(length);
+        return n;
+    }));
+    for (kernels::Isa isa : kIsas) {
+        if (kernels::isSupported(isa)) {
+            std::size_t invalid = 0;
+            reporter.add(measure("validate", kernels::isaName(isa), n, [&] {
+                invalid = utf::findInvalidUtf8(isa, text);
+                return n;
+            }));
+            if (invalid != n) {
+                reporter.note(std::string("the ") + kernels::isaName(isa) + " validation rejected valid text");
+            }
+        }
+    }
+
+    std::u16string utf16;
+    reporter.add(measure("UTF-8 -> UTF-16", "wstring_convert", n, [&] {
+        utf16 = utf16Convert.from_bytes(text);
+        return n;
+    }));
+    for (kernels::Isa isa : kIsas) {
+        if (kernels::isSupported(isa)) {
+            std::u16string converted;
+            reporter.add(measure("UTF-8 -> UTF-16", kernels::isaName(isa), n, [&] {
+                converted = utf::toUtf16(isa, text);
+                return n;
+            }));
+            if (converted != utf16) {
+                reporter.note(std::string("the ") + kernels::isaName(isa) + " UTF-16 differs from wstring_convert");
+            }
+        }
+    }
+
+    std::u32string utf32;
+    reporter.add(measure("UTF-8 -> UTF-32", "wstring_convert", n, [&] {
+        utf32 = utf32Convert.from_bytes(text);
+        return n;
+    }));
+    for (kernels::Isa isa : kIsas) {
+        if (kernels::isSupported(isa)) {
+            std::u32string converted;
+            reporter.add(measure("UTF-8 -> UTF-32", kernels::isaName(isa), n, [&] {
+                converted = utf::toUtf32(isa, text);
+                return n;
+            }));
+            if (converted != utf32) {
+                reporter.note(std::string("the ") + kernels::isaName(isa) + " UTF-32 differs from wstring_convert");
+            }
+        }
+    }
+
+    std::string back;
+    reporter.add(measure("UTF-16 -> UTF-8", "wstring_convert", n, [&] {
+        back = utf16Convert.to_bytes(utf16);
+        return n;
+    }));
+    bench::doNotOptimize(back);
+    for (kernels::Isa isa : kIsas) {
+        if (kernels::isSupported(isa)) {
+            reporter.add(measure("UTF-16 -> UTF-8", kernels::isaName(isa), n, [&] {
+                back = utf::toUtf8(isa, utf16);
+                return n;
+            }));
+            if (back != text) {
+                reporter.note(std::string("the ") + kernels::isaName(isa) + " UTF-8 from UTF-16 differs");
+            }
+        }
+    }
+
+    reporter.add(measure("UTF-32 -> UTF-8", "wstring_convert", n, [&] {
+        back = utf32Convert.to_bytes(utf32);
+        return n;
+    }));
+    bench::doNotOptimize(back);
+    for (kernels::Isa isa : kIsas) {
+        if (kernels::isSupported(isa)) {
+            reporter.add(measure("UTF-32 -> UTF-8", kernels::isaName(isa), n, [&] {
+                back = utf::toUtf8(isa, utf32);
+                return n;
+            }));
+            if (back != text) {
+                reporter.note(std::string("the ") + kernels::isaName(isa) + " UTF-8 from UTF-32 differs");
+            }
+        }
+    }
+}
+
+}
+
+namespace bench {
+
+void runUtfBenchmarks(const Config& config, Reporter& reporter) {
+    reporter.section("Unicode, mostly ASCII text (items = UTF-8 bytes)");
+    runText(reporter, makeText(kEnglish, config.records));
+    reporter.section("Unicode, multilingual text (items = UTF-8 bytes)");
+    runText(reporter, makeText(kMultilingual, config.records));
+}
+
+}
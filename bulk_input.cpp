@@ -0,0 +1,182 @@
+#include "bulk_input.h"
+
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+
+
+BlockReader::BlockReader(const std::string& path, std::size_t blockSize)
+    : file_(nullptr), ownsFile_(path != "-"), blockSize_(blockSize > 0 ? blockSize : kDefaultBlockSize) {
+    if (ownsFile_) {
+        file_ = std::fopen(path.c_str(), "rb");
+        if (file_ == nullptr) {
+            throw std::runtime_error("cannot open input file '" + path + "'");
+        }
+        // Reads are already block sized, so stdio's own buffer would only add a copy
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+    } else {
+        file_ = stdin;
+    }
+}
+
+BlockReader::~BlockReader() {
+    if (ownsFile_) {
+        std::fclose(file_);
+    }
+}
+
+std::size_t BlockReader::read(char* buffer, std::size_t capacity) {
+    std::size_t count = std::fread(buffer, 1, capacity, file_);
+    if (count == 0 && std::ferror(file_)) {
+        throw std::runtime_error("error while reading input");
+    }
+    bytesRead_ += count;
+    return count;
+}
+
+namespace {
+
+// The common case: nothing but decimal digits. Returns false for anything
+// else (signs, whitespace, overflow) so the general path can decide.
+inline bool parseDigitsOnly(std::string_view line, int& value) {
+    if (line.empty() || line.size() > 10) {
+        return false;
+    }
+    long long result = 0;
+    for (char c : line) {
+        unsigned digit = static_cast<unsigned char>(c) - '0';
+        if (digit > 9) {
+            return false;
+        }
+        result = result * 10 + digit;
+    }
+    if (result > std::numeric_limits<int>::max()) {
+        return false;
+    }
+    value = static_cast<int>(result);
+    return true;
+}
+
+// Adds the tokens of one block to the running totals. Adding up a summary
+// per block instead would sum the doubles per block and round differently
+// from summarize() over the whole file.
+void accumulateBlock(ParseSummary& summary, std::string_view block) {
+    Tokenizer tokenizer(block);
+    Token token;
+    while (tokenizer.next(token)) {
+        accumulate(summary, token);
+    }
+}
+
+}
+
+bool acceptPositiveInteger(std::string_view line, int& value) {
+    while (!line.empty() && isSpace(line.front())) {
+        line.remove_prefix(1);
+    }
+    while (!line.empty() && isSpace(line.back())) {
+        line.remove_suffix(1);
+    }
+    // std::cin >> accepts a leading '+', from_chars does not
+    if (line.size() > 1 && line.front() == '+' && line[1] != '-') {
+        line.remove_prefix(1);
+    }
+    const char* last = line.data() + line.size();
+    auto [end, error] = std::from_chars(line.data(), last, value);
+    return error == std::errc() && end == last && value > 0;
+}
+
+ValidationReport& ValidationReport::operator+=(const ValidationReport& other) {
+    if (firstRejectedLine == 0 && other.firstRejectedLine != 0) {
+        firstRejectedLine = lines + other.firstRejectedLine;
+    }
+    lines += other.lines;
+    blank += other.blank;
+    accepted += other.accepted;
+    rejected += other.rejected;
+    acceptedSum += other.acceptedSum;
+    bytes += other.bytes;
+    return *this;
+}
+
+void validateLine(ValidationReport& report, std::string_view line) {
+    report.lines++;
+    int value = 0;
+    if (parseDigitsOnly(line, value) && value > 0) {
+        report.accepted++;
+        report.acceptedSum += value;
+        return;
+    }
+    if (line.find_first_not_of(" \t\r\v\f") == std::string_view::npos) {
+        report.blank++;
+        return;
+    }
+    if (acceptPositiveInteger(line, value)) {
+        report.accepted++;
+        report.acceptedSum += value;
+    } else {
+        report.rejected++;
+        if (report.firstRejectedLine == 0) {
+            report.firstRejectedLine = report.lines;
+        }
+    }
+}
+
+ValidationReport validatePositiveIntegers(BlockReader& reader) {
+    ValidationReport report;
+    reader.forEachLine([&report](std::string_view line) { validateLine(report, line); });
+    report.bytes = reader.bytesRead();
+    return report;
+}
+
+void printReport(std::ostream& out, std::string_view source, const ValidationReport& report) {
+    out << "Validated input from " << source << '\n';
+    out << "   Bytes read: " << report.bytes << '\n';
+    out << "   Lines: " << report.lines << " (" << report.blank << " blank)\n";
+    out << "   Accepted (positive integers): " << report.accepted << '\n';
+    out << "   Rejected: " << report.rejected << '\n';
+    if (report.firstRejectedLine != 0) {
+        out << "   First rejected line: " << report.firstRejectedLine << '\n';
+    }
+    out << "   Sum of accepted values: " << report.acceptedSum << '\n';
+}
+
+ParseSummary summarizeBlocks(BlockReader& reader) {
+    ParseSummary summary;
+    std::vector<char> buffer(reader.blockSize());
+    std::size_t carried = 0;
+    for (;;) {
+        if (carried == buffer.size()) {
+            buffer.resize(buffer.size() * 2);  // One token longer than a block
+        }
+        std::size_t count = reader.read(buffer.data() + carried, buffer.size() - carried);
+        std::string_view block(buffer.data(), carried + count);
+        if (count == 0) {
+            accumulateBlock(summary, block);  // Whatever is left is the last token
+            break;
+        }
+        // Only parse up to the last whitespace: the rest may continue in the next block
+        std::size_t cut = block.size();
+        while (cut > 0 && !isSpace(block[cut - 1])) {
+            cut--;
+        }
+        accumulateBlock(summary, block.substr(0, cut));
+        carried = block.size() - cut;
+        std::memmove(buffer.data(), buffer.data() + cut, carried);
+    }
+    return summary;
+}
+
+void printParseSummary(std::ostream& out, std::string_view source, const ParseSummary& summary) {
+    out << "Parsed " << source << '\n';
+    out << "   Tokens: " << summary.tokens() << '\n';
+    out << "   Ints: " << summary.ints;
+    if (summary.intSumFits()) {
+        out << " (sum " << summary.intSum << ")\n";
+    } else {
+        out << " (sum out of the long long range)\n";
+    }
+    out << "   Doubles: " << summary.doubles << " (sum " << summary.doubleSum << ")\n";
+    out << "   Words: " << summary.words << '\n';
+    out << "   Out of range: " << summary.errors << '\n';
+}
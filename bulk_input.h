@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fast_parse.h"
+
+/*
+ * Bulk input for the std::cin examples in demonstrateModernIO.
+ *
+ * Reading one value at a time with `std::cin >> value` (and recovering from
+ * bad input with cin.clear()/cin.ignore()) costs a formatted extraction per
+ * value. BlockReader reads a file or stdin in large blocks instead and
+ * hands out every line as a std::string_view into its block buffer, so
+ * lines are never copied unless one straddles two blocks.
+ */
+class BlockReader {
+  public:
+      static constexpr std::size_t kDefaultBlockSize = 1 << 20;  // 1 MiB
+
+      // "-" reads stdin. Throws std::runtime_error if the file cannot be opened.
+      explicit BlockReader(const std::string& path, std::size_t blockSize = kDefaultBlockSize);
+      ~BlockReader();
+
+      BlockReader(const BlockReader&) = delete;
+      BlockReader& operator=(const BlockReader&) = delete;
+
+      // Reads up to `capacity` bytes into `buffer`; returns 0 at the end.
+      // Throws std::runtime_error on a read error.
+      std::size_t read(char* buffer, std::size_t capacity);
+
+      // Calls onLine(std::string_view) for every line, without the '\n'.
+      // The view is only valid during the call.
+      template <typename F>
+      void forEachLine(F&& onLine);
+
+      std::size_t blockSize() const { return blockSize_; }
+      std::size_t bytesRead() const { return bytesRead_; }
+
+  private:
+      std::FILE* file_;
+      bool ownsFile_;
+      std::size_t blockSize_;
+      std::size_t bytesRead_ = 0;
+};
+
+template <typename F>
+void BlockReader::forEachLine(F&& onLine) {
+    std::vector<char> buffer(blockSize_);
+    std::size_t carried = 0;  // Start of a line left over from the previous block
+    for (;;) {
+        if (carried == buffer.size()) {
+            buffer.resize(buffer.size() * 2);  // One line longer than a block
+        }
+        std::size_t count = read(buffer.data() + carried, buffer.size() - carried);
+        if (count == 0) {
+            break;
+        }
+        const char* begin = buffer.data();
+        const char* end = begin + carried + count;
+        const char* line = begin;
+        const char* scanFrom = begin + carried;  // The carried part has no '\n'
+        while (const char* newline = static_cast<const char*>(
+                   std::memchr(scanFrom, '\n', static_cast<std::size_t>(end - scanFrom)))) {
+            onLine(std::string_view(line, static_cast<std::size_t>(newline - line)));
+            line = newline + 1;
+            scanFrom = line;
+        }
+        carried = static_cast<std::size_t>(end - line);
+        std::memmove(buffer.data(), line, carried);
+    }
+    if (carried > 0) {
+        onLine(std::string_view(buffer.data(), carried));  // Last line without '\n'
+    }
+}
+
+// Result of validating a stream of "positive number" lines
+struct ValidationReport {
+    std::size_t lines = 0;
+    std::size_t blank = 0;
+    std::size_t accepted = 0;
+    std::size_t rejected = 0;
+    long long acceptedSum = 0;
+    std::size_t firstRejectedLine = 0;  // 1-based, 0 if nothing was rejected
+    std::size_t bytes = 0;
+
+    // Adds the report of the lines that follow these ones
+    ValidationReport& operator+=(const ValidationReport& other);
+};
+
+// Accepts a line when, apart from surrounding whitespace, it is an int > 0
+// (the same rule as the validation loop in demonstrateModernIO)
+bool acceptPositiveInteger(std::string_view line, int& value);
+
+// Counts one line into the report (line numbers are 1-based within it)
+void validateLine(ValidationReport& report, std::string_view line);
+
+ValidationReport validatePositiveIntegers(BlockReader& reader);
+
+void printReport(std::ostream& out, std::string_view source, const ValidationReport& report);
+
+// Runs the Tokenizer over the whole input block by block; a token cut in
+// half by a block boundary is carried over to the next block. Same result
+// as summarize() over the whole input, down to the last bit of doubleSum
+ParseSummary summarizeBlocks(BlockReader& reader);
+
+void printParseSummary(std::ostream& out, std::string_view source, const ParseSummary& summary);
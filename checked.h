@@ -0,0 +1,127 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if __has_include(<expected>)
+#include <expected>
+#endif
+
+/*
+ * Error handling without exceptions, for call sites where errors are
+ * common rather than exceptional (similar to the TryParse pattern in C#,
+ * or to returning { ok, value, error } from a JavaScript function).
+ *
+ * Expected<T, E> holds either a T or an E. It is std::expected (C++23)
+ * when the standard library has it, and a small stand-in with the same
+ * members (has_value, value, error, value_or, operator*, operator bool)
+ * otherwise. Failing costs a branch instead of unwinding the stack: throwing
+ * and catching an exception takes microseconds.
+ */
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+
+template <typename T, typename E>
+using Expected = std::expected<T, E>;
+
+template <typename E>
+using Unexpected = std::unexpected<E>;
+
+#else
+
+// The error half of an Expected (std::unexpected before C++23)
+template <typename E>
+class Unexpected {
+  public:
+      explicit Unexpected(E error) : error_(std::move(error)) {}
+      const E& error() const { return error_; }
+
+  private:
+      E error_;
+};
+
+template <typename T, typename E>
+class Expected {
+  public:
+      Expected(T value) : hasValue_(true), value_(std::move(value)) {}
+      Expected(Unexpected<E> error) : hasValue_(false), error_(error.error()) {}
+
+      bool has_value() const { return hasValue_; }
+      explicit operator bool() const { return hasValue_; }
+
+      // value() throws when there is none, like std::expected (with
+      // std::logic_error instead of std::bad_expected_access)
+      const T& value() const {
+          if (!hasValue_) {
+              throw std::logic_error("Expected has no value");
+          }
+          return value_;
+      }
+      const T& operator*() const { return value_; }
+      const T* operator->() const { return &value_; }
+      const E& error() const { return error_; }
+
+      T value_or(T fallback) const { return hasValue_ ? value_ : std::move(fallback); }
+
+  private:
+      // Both members always exist: simpler than a union, and fine for the
+      // small trivially constructible types used here
+      bool hasValue_;
+      T value_{};
+      E error_{};
+};
+
+#endif
+
+enum class ErrorCode {
+    None,
+    DivisionByZero,
+    Overflow,
+    OutOfRange,
+};
+
+inline const char* errorMessage(ErrorCode code) {
+    switch (code) {
+        case ErrorCode::None: return "no error";
+        case ErrorCode::DivisionByZero: return "Division by zero!";
+        case ErrorCode::Overflow: return "Integer overflow!";
+        case ErrorCode::OutOfRange: return "Index out of range!";
+    }
+    return "unknown error";
+}
+
+// ----- Division -----
+
+// numerator / denominator, or DivisionByZero / Overflow (INT_MIN / -1)
+inline Expected<int, ErrorCode> checkedDivide(int numerator, int denominator) {
+    if (denominator == 0) {
+        return Unexpected<ErrorCode>(ErrorCode::DivisionByZero);
+    }
+    if (numerator == INT_MIN && denominator == -1) {
+        return Unexpected<ErrorCode>(ErrorCode::Overflow);
+    }
+    return numerator / denominator;
+}
+
+// The exception version, as in demonstrateErrorHandling: throws std::runtime_error
+inline int divideOrThrow(int numerator, int denominator) {
+    Expected<int, ErrorCode> result = checkedDivide(numerator, denominator);
+    if (!result) {
+        throw std::runtime_error(errorMessage(result.error()));
+    }
+    return *result;
+}
+
+// ----- Element access -----
+
+// A copy of values[index], or OutOfRange (vector::at would throw std::out_of_range)
+template <typename T>
+Expected<T, ErrorCode> checkedAt(const std::vector<T>& values, std::size_t index) {
+    if (index >= values.size()) {
+        return Unexpected<ErrorCode>(ErrorCode::OutOfRange);
+    }
+    return values[index];
+}
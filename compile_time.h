@@ -0,0 +1,454 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "utf.h"
+
+/*
+ * The pure computations of the tutorial as constexpr functions, so the
+ * compiler can evaluate them (similar to const fields in C#, which must be
+ * compile-time constants, but for whole functions). Every result is
+ * checked with static_assert: a wrong answer is a compile error.
+ *
+ * The second half is the code of the tutorial sections that do no real
+ * I/O, written over any output type. main.cpp runs it into std::cout;
+ * the compiler also runs it into string constants, and with --precomputed
+ * those sections write one constant each instead of formatting anything.
+ */
+namespace compile_time {
+
+// ----- Pure functions -----
+
+// Function with return value (similar to C# and JavaScript)
+constexpr int returnSum(int a, int b) {
+    return a + b;
+}
+
+// Default parameters (similar to C# and JavaScript)
+constexpr int defaultParamFunction(int a = 1, int b = 2) {
+    return a + b;
+}
+
+// Lambdas are constexpr too when their body allows it (C++17)
+inline constexpr auto add = [](int a, int b) { return a + b; };
+
+// Returns a lambda that captures `multiplier` by value
+constexpr auto makeMultiplier(int multiplier) {
+    return [multiplier](int x) { return x * multiplier; };
+}
+
+// Integer division truncates toward zero. Dividing by zero throws, which
+// inside a constant expression is a compile error instead of a crash.
+constexpr int divideInts(int a, int b) {
+    if (b == 0) {
+        throw std::domain_error("division by zero");
+    }
+    return a / b;
+}
+
+constexpr double divideWithConversion(int a, int b) {
+    return static_cast<double>(a) / b;
+}
+
+static_assert(returnSum(5, 7) == 12);
+static_assert(defaultParamFunction() == 3);
+static_assert(defaultParamFunction(10) == 12);
+static_assert(defaultParamFunction(10, 20) == 30);
+static_assert(add(3, 4) == 7);
+static_assert(makeMultiplier(10)(5) == 50);
+static_assert(divideInts(5, 2) == 2);
+static_assert(divideInts(-5, 2) == -2);
+static_assert(divideWithConversion(5, 2) == 2.5);
+
+// ----- Compile-time text -----
+
+// A fixed-capacity string that can be built inside constexpr code
+// (std::string only became usable there in C++20, and cannot outlive
+// the constant evaluation)
+template <std::size_t Capacity>
+class StaticText {
+  public:
+      constexpr void append(std::string_view text) {
+          if (text.size() > Capacity - size_) {
+              throw std::length_error("StaticText: capacity exceeded");
+          }
+          for (char c : text) {
+              data_[size_++] = c;
+          }
+      }
+
+      constexpr void append(char c) { append(std::string_view(&c, 1)); }
+
+      constexpr void appendNumber(long long value) {
+          char digits[24] = {};
+          std::size_t count = 0;
+          unsigned long long magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value)
+                                                   : static_cast<unsigned long long>(value);
+          do {
+              digits[count++] = static_cast<char>('0' + magnitude % 10);
+              magnitude /= 10;
+          } while (magnitude != 0);
+          if (value < 0) {
+              append('-');
+          }
+          while (count > 0) {
+              append(digits[--count]);
+          }
+      }
+
+      // The same text as `std::cout << value` with default settings: %g
+      // with 6 significant digits, trailing zeros removed
+      constexpr void appendDouble(double value) {
+          if (value != value) {
+              append("nan");
+              return;
+          }
+          if (value < 0) {
+              append('-');
+              value = -value;
+          }
+          if (value > 1.7976931348623157e308) {
+              append("inf");
+              return;
+          }
+          if (value == 0) {
+              append('0');
+              return;
+          }
+          // value = mantissa * 10^(exponent - 5), with a 6-digit mantissa
+          int exponent = 0;
+          while (value >= powerOfTen(exponent + 1)) {
+              exponent++;
+          }
+          while (value < powerOfTen(exponent)) {
+              exponent--;
+          }
+          // One rounding step (powers of ten up to 1e22 are exact doubles)
+          double scaled = exponent >= 5 ? value / powerOfTen(exponent - 5) : value * powerOfTen(5 - exponent);
+          long long mantissa = static_cast<long long>(scaled);
+          double fraction = scaled - static_cast<double>(mantissa);
+          if (fraction > 0.5 || (fraction == 0.5 && mantissa % 2 == 1)) {
+              mantissa++;  // Round half to even, like printf
+          }
+          if (mantissa >= 1000000) {
+              mantissa /= 10;
+              exponent++;
+          }
+          char digits[6] = {};
+          for (int i = 5; i >= 0; i--) {
+              digits[i] = static_cast<char>('0' + mantissa % 10);
+              mantissa /= 10;
+          }
+          int significant = 6;
+          while (significant > 1 && digits[significant - 1] == '0') {
+              significant--;
+          }
+
+          if (exponent < -4 || exponent >= 6) {
+              append(digits[0]);
+              if (significant > 1) {
+                  append('.');
+                  append(std::string_view(digits + 1, static_cast<std::size_t>(significant - 1)));
+              }
+              append(exponent < 0 ? "e-" : "e+");
+              int magnitude = exponent < 0 ? -exponent : exponent;
+              if (magnitude < 10) {
+                  append('0');
+              }
+              appendNumber(magnitude);
+          } else if (exponent < 0) {
+              append("0.");
+              for (int i = -1; i > exponent; i--) {
+                  append('0');
+              }
+              append(std::string_view(digits, static_cast<std::size_t>(significant)));
+          } else {
+              int integerDigits = exponent + 1;
+              for (int i = 0; i < integerDigits; i++) {
+                  append(digits[i]);
+              }
+              if (significant > integerDigits) {
+                  append('.');
+                  append(std::string_view(digits + integerDigits, static_cast<std::size_t>(significant - integerDigits)));
+              }
+          }
+      }
+
+      // Encodes UTF-16 or UTF-32 as UTF-8, with U+FFFD for an unpaired
+      // surrogate or a code point past U+10FFFF (as utf::asUtf8 prints them)
+      template <typename Unit>
+      constexpr void appendUtf8(std::basic_string_view<Unit> text) {
+          for (std::size_t i = 0; i < text.size(); i++) {
+              char32_t c = static_cast<char32_t>(static_cast<std::make_unsigned_t<Unit>>(text[i]));
+              if (sizeof(Unit) == 2 && c >= 0xD800 && c <= 0xDBFF && i + 1 < text.size()) {
+                  char32_t low = static_cast<char32_t>(static_cast<std::make_unsigned_t<Unit>>(text[i + 1]));
+                  if (low >= 0xDC00 && low <= 0xDFFF) {
+                      c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                      i++;
+                  }
+              }
+              if ((c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) {
+                  c = 0xFFFD;
+              }
+              if (c < 0x80) {
+                  append(static_cast<char>(c));
+              } else if (c < 0x800) {
+                  append(static_cast<char>(0xC0 | (c >> 6)));
+                  append(static_cast<char>(0x80 | (c & 0x3F)));
+              } else if (c < 0x10000) {
+                  append(static_cast<char>(0xE0 | (c >> 12)));
+                  append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                  append(static_cast<char>(0x80 | (c & 0x3F)));
+              } else {
+                  append(static_cast<char>(0xF0 | (c >> 18)));
+                  append(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+                  append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                  append(static_cast<char>(0x80 | (c & 0x3F)));
+              }
+          }
+      }
+
+      // ----- operator<<, so the sections below write to a StaticText
+      // with the same code as to an std::ostream -----
+      constexpr StaticText& operator<<(std::string_view text) { append(text); return *this; }
+      // Without this a string literal would pick the bool conversion
+      constexpr StaticText& operator<<(const char* text) { append(std::string_view(text)); return *this; }
+      constexpr StaticText& operator<<(char c) { append(c); return *this; }
+      constexpr StaticText& operator<<(int value) { appendNumber(value); return *this; }
+      constexpr StaticText& operator<<(long long value) { appendNumber(value); return *this; }
+      constexpr StaticText& operator<<(double value) { appendDouble(value); return *this; }
+      template <typename Unit>
+      constexpr StaticText& operator<<(utf::Utf8Printer<Unit> printer) { appendUtf8(printer.text); return *this; }
+
+      constexpr std::string_view view() const { return {data_, size_}; }
+      constexpr std::size_t size() const { return size_; }
+
+  private:
+      static constexpr double powerOfTen(int exponent) {
+          double result = 1;
+          for (int i = 0; i < exponent; i++) {
+              result *= 10;
+          }
+          for (int i = 0; i > exponent; i--) {
+              result /= 10;
+          }
+          return result;
+      }
+
+      char data_[Capacity] = {};
+      std::size_t size_ = 0;
+};
+
+// Renders Section::write into a StaticText of exactly the right size:
+// once into a large scratch buffer to measure it, then for real
+template <typename Section>
+consteval std::size_t renderedSize() {
+    StaticText<16 * 1024> scratch;
+    Section::write(scratch);
+    return scratch.size();
+}
+
+template <typename Section>
+inline constexpr auto rendered = [] {
+    StaticText<renderedSize<Section>()> text;
+    Section::write(text);
+    return text;
+}();
+
+// ----- Section texts -----
+// The first four sections of the tutorial, written once for any output
+// with a stream-like operator<<: main.cpp runs them into an std::ostream,
+// and `rendered` below runs them into a StaticText at compile time for
+// --precomputed. Both outputs come from the same code, so they cannot
+// drift apart (the tutorial benchmark compares them byte for byte).
+
+struct BasicSyntaxSection {
+    template <typename Out>
+    static constexpr void write(Out& out) {
+        out << "\n----- Basic Syntax -----\n";
+
+        // Comments are the same as in C# and JavaScript
+        // Single line comment
+
+        /*
+         * Multi-line comment
+         */
+
+        // Statements end with semicolons (like C# and unlike JavaScript where they're optional)
+        out << "Hello, World!" << '\n';
+
+        // std::cout is for console output (similar to Console.WriteLine in C# or console.log in JS)
+        // << is the stream insertion operator
+        // std::endl inserts a newline and flushes the buffer (similar to \n but with flush)
+        // The sections here write to `out` instead, a buffered sink (see output_sink.h)
+        // that ends lines with '\n' and flushes once per section rather than per line
+    }
+};
+
+struct VariablesAndTypesSection {
+    template <typename Out>
+    static constexpr void write(Out& out) {
+        out << "\n----- Variables and Types -----\n";
+
+        // C++ is statically typed
+        // Basic types
+        int integerValue = 42;                 // 32-bit integer
+        double floatingPoint = 3.14159;        // Double precision floating point
+        char singleCharacter = 'A';            // Single character
+        bool booleanValue = true;              // Boolean (true/false)
+
+        // In C++, strings are objects, not primitive types like in C#
+        std::string text = "Hello, C++";       // String class
+
+        // C++ has const for constants (similar to const in C# and JavaScript)
+        [[maybe_unused]] const int unchangeable = 100;
+
+        // C++ handles Unicode differently than C# and JavaScript
+        // Unicode strings often use wstring, u16string, or u32string
+        std::wstring wideText = L"Wide character string";
+        // u"..." is UTF-16 and U"..." UTF-32 on every platform (wchar_t is not)
+        std::u16string utf16Text = u"Gr\u00FC\u00DFe, \u4E16\u754C";
+
+        // Print variables
+        out << "Integer: " << integerValue << '\n';
+        out << "Double: " << floatingPoint << '\n';
+        out << "Char: " << singleCharacter << '\n';
+        // A bool prints as 1 or 0 unless the stream is given std::boolalpha
+        out << "Boolean: " << (booleanValue ? "true" : "false") << '\n';
+        out << "String: " << text << '\n';
+        // std::ostream only prints char strings: utf::asUtf8 converts the wide
+        // ones on the way (string is UTF-8 here, like string in JS or Go)
+        out << "Wide string: " << utf::asUtf8(wideText) << '\n';
+        out << "UTF-16 string: " << utf::asUtf8(utf16Text) << '\n';
+
+        // Type conversion (more explicit than JavaScript, similar to C#)
+        int x = 5;
+        double y = divideWithConversion(x, 2);  // 2.5 (not 2 because of explicit conversion)
+        out << "5/2 with conversion: " << y << '\n';
+
+        // Without conversion, integer division would truncate
+        // (divideInts checks this with static_assert above)
+        out << "5/2 without conversion: " << divideInts(x, 2) << '\n';
+    }
+};
+
+struct ControlFlowSection {
+    template <typename Out>
+    static constexpr void write(Out& out) {
+        out << "\n----- Control Flow -----\n";
+
+        // If statements (similar to C# and JavaScript)
+        int x = 10;
+        if (x > 5) {
+            out << "x is greater than 5" << '\n';
+        } else if (x == 5) {
+            out << "x is equal to 5" << '\n';
+        } else {
+            out << "x is less than 5" << '\n';
+        }
+
+        // Switch statements (similar to C# and JavaScript)
+        switch (x) {
+            case 5:
+                out << "x is 5" << '\n';
+                break;
+            case 10:
+                out << "x is 10" << '\n';
+                break;
+            default:
+                out << "x is neither 5 nor 10" << '\n';
+                break;
+        }
+
+        // For loop (similar to C# and JavaScript)
+        out << "For loop: ";
+        for (int i = 0; i < 5; i++) {
+            out << i << " ";
+        }
+        out << '\n';
+
+        // Range-based for loop (similar to foreach in C# or for...of in JavaScript)
+        std::vector<int> numbers = {1, 2, 3, 4, 5};
+        out << "Range-based for loop: ";
+        for (int num : numbers) {
+            out << num << " ";
+        }
+        out << '\n';
+
+        // While loop (similar to C# and JavaScript)
+        out << "While loop: ";
+        int i = 0;
+        while (i < 5) {
+            out << i << " ";
+            i++;
+        }
+        out << '\n';
+
+        // Do-while loop (similar to C# and JavaScript)
+        out << "Do-while loop: ";
+        i = 0;
+        do {
+            out << i << " ";
+            i++;
+        } while (i < 5);
+        out << '\n';
+    }
+};
+
+// demonstrateFunctions(42) in main.cpp, followed by a function with a return value
+struct FunctionsSection {
+    // Function with a parameter (similar to C# and JavaScript)
+    template <typename Out>
+    static constexpr void write(Out& out, int value = 42) {
+        out << "\n----- Functions -----\n";
+        out << "Function parameter: " << value << '\n';
+
+        // Local variable scope (similar to C# and JavaScript)
+        {
+            int localVar = 100;
+            out << "Inside local scope: " << localVar << '\n';
+        }
+        // localVar is not accessible here
+
+        // Default parameters (similar to C# and JavaScript):
+        // defaultParamFunction(int a = 1, int b = 2), above
+        out << "Default params (no args): " << defaultParamFunction() << '\n';
+        out << "Default params (one arg): " << defaultParamFunction(10) << '\n';
+        out << "Default params (two args): " << defaultParamFunction(10, 20) << '\n';
+
+        // Function with return value, returnSum above
+        out << "Sum: " << returnSum(5, 7) << '\n';
+    }
+};
+
+inline constexpr std::string_view basicSyntaxText = rendered<BasicSyntaxSection>.view();
+inline constexpr std::string_view variablesAndTypesText = rendered<VariablesAndTypesSection>.view();
+inline constexpr std::string_view controlFlowText = rendered<ControlFlowSection>.view();
+inline constexpr std::string_view functionsText = rendered<FunctionsSection>.view();
+
+// string_view::find compares character pointers, which GCC's
+// -fsanitize=undefined checks make non-constant; indexes stay constant
+constexpr bool containsText(std::string_view text, std::string_view part) {
+    for (std::size_t start = 0; start + part.size() <= text.size(); start++) {
+        std::size_t i = 0;
+        while (i < part.size() && text[start + i] == part[i]) {
+            i++;
+        }
+        if (i == part.size()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static_assert(functionsText.ends_with("Default params (two args): 30\nSum: 12\n"));
+static_assert(containsText(variablesAndTypesText, "UTF-16 string: Gr\u00FC\u00DFe, \u4E16\u754C\n"));
+static_assert(containsText(variablesAndTypesText, "Double: 3.14159\n"));
+static_assert(containsText(variablesAndTypesText, "5/2 with conversion: 2.5\n"));
+
+}
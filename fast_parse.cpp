@@ -0,0 +1,95 @@
+#include "fast_parse.h"
+
+#include <charconv>
+
+Token classifyToken(std::string_view text, std::size_t offset) {
+    Token token;
+    token.text = text;
+    token.offset = offset;
+    const char* first = text.data();
+    const char* last = first + text.size();
+
+    // Integers first: "123" must not become the double 123.0
+    auto asInt = std::from_chars(first, last, token.intValue);
+    if (asInt.ptr == last && asInt.ec != std::errc::invalid_argument) {
+        token.kind = TokenKind::Int;
+        token.error = asInt.ec;
+        return token;
+    }
+
+    auto asDouble = std::from_chars(first, last, token.doubleValue);
+    if (asDouble.ptr == last && asDouble.ec != std::errc::invalid_argument) {
+        token.kind = TokenKind::Double;
+        token.intValue = 0;
+        token.error = asDouble.ec;
+        return token;
+    }
+
+    // Anything else, including numbers with trailing text like "12abc"
+    token.kind = TokenKind::Word;
+    token.intValue = 0;
+    token.doubleValue = 0;
+    return token;
+}
+
+bool Tokenizer::next(Token& token) {
+    const std::size_t size = input_.size();
+    while (position_ < size && isSpace(input_[position_])) {
+        position_++;
+    }
+    if (position_ == size) {
+        return false;
+    }
+    std::size_t start = position_;
+    while (position_ < size && !isSpace(input_[position_])) {
+        position_++;
+    }
+    token = classifyToken(input_.substr(start, position_ - start), start);
+    return true;
+}
+
+void accumulate(ParseSummary& summary, const Token& token) {
+    switch (token.kind) {
+        case TokenKind::Int:
+            summary.ints++;
+            summary.addInt(token.intValue);
+            break;
+        case TokenKind::Double:
+            summary.doubles++;
+            summary.doubleSum += token.doubleValue;
+            break;
+        case TokenKind::Word:
+            summary.words++;
+            break;
+    }
+    if (!token.ok()) {
+        summary.errors++;
+    }
+}
+
+void ParseSummary::addInt(long long value, long long wraps) {
+    if (__builtin_add_overflow(intSum, value, &intSum)) {
+        wraps += value < 0 ? -1 : 1;   // intSum holds the low 64 bits of the true sum
+    }
+    intSumWraps += wraps;
+}
+
+ParseSummary& ParseSummary::operator+=(const ParseSummary& other) {
+    ints += other.ints;
+    doubles += other.doubles;
+    words += other.words;
+    errors += other.errors;
+    addInt(other.intSum, other.intSumWraps);
+    doubleSum += other.doubleSum;
+    return *this;
+}
+
+ParseSummary summarize(std::string_view input) {
+    ParseSummary summary;
+    Tokenizer tokenizer(input);
+    Token token;
+    while (tokenizer.next(token)) {
+        accumulate(summary, token);
+    }
+    return summary;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+
+/*
+ * A <charconv>-based tokenizer for whitespace-delimited text such as
+ * "123 3.14 Hello" (the string-stream parsing demo in demonstrateModernIO).
+ *
+ * Unlike std::istringstream or std::stoi it never allocates, never looks
+ * at the locale and does not need to know the order of the fields: every
+ * token is classified as an integer, a floating point number or a word.
+ * The tokens are string_views into the caller's buffer, so the buffer
+ * must outlive them.
+ */
+enum class TokenKind { Int, Double, Word };
+
+struct Token {
+    TokenKind kind = TokenKind::Word;
+    std::string_view text;      // The token as it appears in the input
+    std::size_t offset = 0;     // Byte offset of the token in the input
+    long long intValue = 0;     // Set when kind == Int
+    double doubleValue = 0;     // Set when kind == Double
+    std::errc error{};          // std::errc::result_out_of_range if the number does not fit
+
+    bool ok() const { return error == std::errc{}; }
+};
+
+class Tokenizer {
+  public:
+      explicit Tokenizer(std::string_view input) : input_(input) {}
+
+      // Reads the next token; returns false at the end of the input
+      bool next(Token& token);
+
+      // Where the next token search starts
+      std::size_t offset() const { return position_; }
+
+  private:
+      std::string_view input_;
+      std::size_t position_ = 0;
+};
+
+// Classifies one token (no whitespace inside) the same way Tokenizer does
+Token classifyToken(std::string_view text, std::size_t offset = 0);
+
+// Totals over a whole buffer, e.g. for reporting on a large input file
+struct ParseSummary {
+    std::size_t ints = 0;
+    std::size_t doubles = 0;
+    std::size_t words = 0;
+    std::size_t errors = 0;          // Numbers that were out of range
+    long long intSum = 0;            // Modulo 2^64 when intSumWraps != 0
+    long long intSumWraps = 0;       // Times intSum went past LLONG_MAX (+1) or LLONG_MIN (-1)
+    double doubleSum = 0;
+
+    std::size_t tokens() const { return ints + doubles + words; }
+    // The true sum is intSum + intSumWraps * 2^64, so it fits in intSum only when nothing wrapped
+    bool intSumFits() const { return intSumWraps == 0; }
+
+    // Adds to intSum without signed overflow (undefined behaviour), in any order:
+    // the wrapped intSum and intSumWraps come out the same for the same total
+    void addInt(long long value, long long wraps = 0);
+
+    // Adds the totals of a later part of the same input
+    ParseSummary& operator+=(const ParseSummary& other);
+};
+
+ParseSummary summarize(std::string_view input);
+
+// Adds one token to the running totals
+void accumulate(ParseSummary& summary, const Token& token);
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
@@ -0,0 +1,384 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+ * Three interchangeable string-keyed maps for tables such as the "ages"
+ * map in demonstrateStl (all similar to Dictionary<string, V> in C#):
+ *
+ *  - FlatHashMap: open addressing over a dense array of entries. No
+ *    allocation per entry and one or two cache misses per lookup.
+ *  - SortedVectorMap: a sorted std::vector searched with binary search.
+ *    Compact and fast to iterate in order, but inserting in the middle
+ *    shifts everything after it (use insertBulk for large batches).
+ *  - StdMap: the std::map red-black tree, with std::less<> so it can be
+ *    searched with a string_view.
+ *
+ * All three take std::string_view keys, so `ages["Alice"]` never builds a
+ * temporary std::string just to look something up: a key is only copied
+ * into a std::string when it is inserted.
+ */
+
+// The shared interface (checked at compile time, like a C# interface
+// constraint `where M : IStringMap<V>`)
+template <typename M>
+concept StringMap = requires(M map, const M constMap, std::string_view key, typename M::mapped_type value) {
+    { map[key] } -> std::same_as<typename M::mapped_type&>;
+    { map.insert(key, value) } -> std::same_as<bool>;
+    { map.find(key) } -> std::same_as<typename M::mapped_type*>;
+    { constMap.contains(key) } -> std::same_as<bool>;
+    { map.erase(key) } -> std::same_as<bool>;
+    { constMap.size() } -> std::same_as<std::size_t>;
+    map.reserve(std::size_t{});
+    map.clear();
+    // visit(std::string_view key, mapped_type& value), in ascending key order
+    map.forEachOrdered([](std::string_view, typename M::mapped_type&) {});
+};
+
+// ----- Open addressing hash map -----
+template <typename V>
+class FlatHashMap {
+  public:
+      using mapped_type = V;
+
+      V& operator[](std::string_view key) {
+          return entries_[findOrInsert(key, V{}).first].value;
+      }
+
+      // Adds key -> value unless the key exists; true if it was added
+      bool insert(std::string_view key, V value) {
+          return findOrInsert(key, std::move(value)).second;
+      }
+
+      V* find(std::string_view key) {
+          std::size_t index = indexOf(key);
+          return index == kMissing ? nullptr : &entries_[index].value;
+      }
+      const V* find(std::string_view key) const {
+          std::size_t index = indexOf(key);
+          return index == kMissing ? nullptr : &entries_[index].value;
+      }
+
+      bool contains(std::string_view key) const { return indexOf(key) != kMissing; }
+
+      bool erase(std::string_view key) {
+          if (slots_.empty()) {
+              return false;
+          }
+          const std::uint64_t h = hash(key);
+          std::size_t slot = findSlot(key, h);
+          if (slots_[slot] == 0) {
+              return false;
+          }
+          const std::size_t index = slots_[slot] - 1;
+          removeSlot(slot);
+          // Keep the entries dense: the last one moves into the hole
+          const std::size_t last = entries_.size() - 1;
+          if (index != last) {
+              std::size_t lastSlot = findSlot(entries_[last].key, hashes_[last]);
+              slots_[lastSlot] = static_cast<std::uint32_t>(index + 1);
+              entries_[index] = std::move(entries_[last]);
+              hashes_[index] = hashes_[last];
+          }
+          entries_.pop_back();
+          hashes_.pop_back();
+          return true;
+      }
+
+      std::size_t size() const { return entries_.size(); }
+
+      void reserve(std::size_t count) {
+          entries_.reserve(count);
+          hashes_.reserve(count);
+          if (count * 4 > slots_.size() * 3) {
+              rehash(slotCountFor(count));
+          }
+      }
+
+      void clear() {
+          entries_.clear();
+          hashes_.clear();
+          std::fill(slots_.begin(), slots_.end(), 0);
+      }
+
+      // Entries in insertion order (the cheapest way to visit everything)
+      template <typename F>
+      void forEach(F&& visit) {
+          for (Entry& entry : entries_) {
+              visit(std::string_view(entry.key), entry.value);
+          }
+      }
+
+      // A hash table has no order: this sorts an index of the entries first
+      template <typename F>
+      void forEachOrdered(F&& visit) {
+          std::vector<std::uint32_t> order(entries_.size());
+          for (std::size_t i = 0; i < order.size(); i++) {
+              order[i] = static_cast<std::uint32_t>(i);
+          }
+          std::sort(order.begin(), order.end(), [this](std::uint32_t a, std::uint32_t b) {
+              return entries_[a].key < entries_[b].key;
+          });
+          for (std::uint32_t i : order) {
+              visit(std::string_view(entries_[i].key), entries_[i].value);
+          }
+      }
+
+      // Bytes held by the table (not counting strings too long for the small string buffer)
+      std::size_t memoryUsage() const {
+          return entries_.capacity() * sizeof(Entry) + hashes_.capacity() * sizeof(std::uint64_t)
+               + slots_.capacity() * sizeof(std::uint32_t);
+      }
+
+  private:
+      struct Entry {
+          std::string key;
+          V value;
+      };
+
+      static constexpr std::size_t kMissing = static_cast<std::size_t>(-1);
+
+      static std::uint64_t hash(std::string_view key) { return std::hash<std::string_view>{}(key); }
+
+      // Smallest power of two that keeps `count` entries at most 3/4 full
+      static std::size_t slotCountFor(std::size_t count) {
+          std::size_t slots = 16;
+          while (count * 4 > slots * 3) {
+              slots *= 2;
+          }
+          return slots;
+      }
+
+      // The slot holding `key`, or the empty slot where it would go
+      std::size_t findSlot(std::string_view key, std::uint64_t h) const {
+          const std::size_t mask = slots_.size() - 1;
+          std::size_t slot = static_cast<std::size_t>(h) & mask;
+          for (;;) {
+              std::uint32_t entry = slots_[slot];
+              if (entry == 0 || (hashes_[entry - 1] == h && entries_[entry - 1].key == key)) {
+                  return slot;
+              }
+              slot = (slot + 1) & mask;
+          }
+      }
+
+      std::size_t indexOf(std::string_view key) const {
+          if (slots_.empty()) {
+              return kMissing;
+          }
+          std::uint32_t entry = slots_[findSlot(key, hash(key))];
+          return entry == 0 ? kMissing : entry - 1;
+      }
+
+      // (index of the entry, whether it was inserted)
+      std::pair<std::size_t, bool> findOrInsert(std::string_view key, V&& value) {
+          if ((entries_.size() + 1) * 4 > slots_.size() * 3) {
+              rehash(slotCountFor(entries_.size() + 1));
+          }
+          const std::uint64_t h = hash(key);
+          std::size_t slot = findSlot(key, h);
+          if (slots_[slot] != 0) {
+              return {slots_[slot] - 1, false};
+          }
+          if (entries_.size() >= 0xFFFFFFFEu) {
+              throw std::length_error("FlatHashMap: too many entries for 32-bit indices");
+          }
+          entries_.push_back(Entry{std::string(key), std::move(value)});
+          hashes_.push_back(h);
+          slots_[slot] = static_cast<std::uint32_t>(entries_.size());
+          return {entries_.size() - 1, true};
+      }
+
+      // Backward-shift deletion: later entries of the probe run move up, so
+      // no "deleted" markers are needed
+      void removeSlot(std::size_t hole) {
+          const std::size_t mask = slots_.size() - 1;
+          std::size_t next = (hole + 1) & mask;
+          while (slots_[next] != 0) {
+              std::size_t home = static_cast<std::size_t>(hashes_[slots_[next] - 1]) & mask;
+              // Move it if its home slot is not in (hole, next]
+              if (((next - home) & mask) >= ((next - hole) & mask)) {
+                  slots_[hole] = slots_[next];
+                  hole = next;
+              }
+              next = (next + 1) & mask;
+          }
+          slots_[hole] = 0;
+      }
+
+      void rehash(std::size_t slotCount) {
+          slots_.assign(slotCount, 0);
+          const std::size_t mask = slotCount - 1;
+          for (std::size_t i = 0; i < entries_.size(); i++) {
+              std::size_t slot = static_cast<std::size_t>(hashes_[i]) & mask;
+              while (slots_[slot] != 0) {
+                  slot = (slot + 1) & mask;
+              }
+              slots_[slot] = static_cast<std::uint32_t>(i + 1);
+          }
+      }
+
+      std::vector<Entry> entries_;
+      std::vector<std::uint64_t> hashes_;  // Hash of each entry, so growing does not rehash keys
+      std::vector<std::uint32_t> slots_;   // Entry index + 1, 0 means empty
+};
+
+// ----- Sorted vector with binary search -----
+template <typename V>
+class SortedVectorMap {
+  public:
+      using mapped_type = V;
+
+      V& operator[](std::string_view key) {
+          auto it = lowerBound(key);
+          if (it == entries_.end() || it->first != key) {
+              it = entries_.emplace(it, std::string(key), V{});
+          }
+          return it->second;
+      }
+
+      bool insert(std::string_view key, V value) {
+          auto it = lowerBound(key);
+          if (it != entries_.end() && it->first == key) {
+              return false;
+          }
+          entries_.emplace(it, std::string(key), std::move(value));
+          return true;
+      }
+
+      // Adds many entries at once: append, sort and drop duplicates (the
+      // first occurrence wins). O(n log n) instead of O(n) per insert.
+      template <typename Range>
+      void insertBulk(Range&& items) {
+          const std::size_t oldSize = entries_.size();
+          for (auto&& [key, value] : items) {
+              entries_.emplace_back(std::string(key), value);
+          }
+          // Stable, so existing entries and earlier duplicates come first
+          std::stable_sort(entries_.begin() + static_cast<std::ptrdiff_t>(oldSize), entries_.end(), byKey);
+          std::inplace_merge(entries_.begin(), entries_.begin() + static_cast<std::ptrdiff_t>(oldSize),
+                             entries_.end(), byKey);
+          auto last = std::unique(entries_.begin(), entries_.end(),
+                                  [](const Entry& a, const Entry& b) { return a.first == b.first; });
+          entries_.erase(last, entries_.end());
+      }
+
+      V* find(std::string_view key) {
+          auto it = lowerBound(key);
+          return it != entries_.end() && it->first == key ? &it->second : nullptr;
+      }
+      const V* find(std::string_view key) const {
+          auto it = std::lower_bound(entries_.begin(), entries_.end(), key, keyLess);
+          return it != entries_.end() && it->first == key ? &it->second : nullptr;
+      }
+
+      bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+      bool erase(std::string_view key) {
+          auto it = lowerBound(key);
+          if (it == entries_.end() || it->first != key) {
+              return false;
+          }
+          entries_.erase(it);
+          return true;
+      }
+
+      std::size_t size() const { return entries_.size(); }
+      void reserve(std::size_t count) { entries_.reserve(count); }
+      void clear() { entries_.clear(); }
+
+      template <typename F>
+      void forEachOrdered(F&& visit) {
+          for (Entry& entry : entries_) {
+              visit(std::string_view(entry.first), entry.second);
+          }
+      }
+
+      std::size_t memoryUsage() const { return entries_.capacity() * sizeof(Entry); }
+
+  private:
+      using Entry = std::pair<std::string, V>;
+
+      static bool keyLess(const Entry& entry, std::string_view key) { return entry.first < key; }
+      static bool byKey(const Entry& a, const Entry& b) { return a.first < b.first; }
+
+      typename std::vector<Entry>::iterator lowerBound(std::string_view key) {
+          return std::lower_bound(entries_.begin(), entries_.end(), key, keyLess);
+      }
+
+      std::vector<Entry> entries_;
+};
+
+// ----- std::map behind the same interface -----
+template <typename V>
+class StdMap {
+  public:
+      using mapped_type = V;
+
+      // std::less<> makes find() accept a string_view; only an actual
+      // insert converts the key to a std::string
+      V& operator[](std::string_view key) {
+          auto it = map_.find(key);
+          if (it == map_.end()) {
+              it = map_.emplace(std::string(key), V{}).first;
+          }
+          return it->second;
+      }
+
+      bool insert(std::string_view key, V value) {
+          auto it = map_.lower_bound(key);
+          if (it != map_.end() && it->first == key) {
+              return false;
+          }
+          map_.emplace_hint(it, std::string(key), std::move(value));
+          return true;
+      }
+
+      V* find(std::string_view key) {
+          auto it = map_.find(key);
+          return it == map_.end() ? nullptr : &it->second;
+      }
+      const V* find(std::string_view key) const {
+          auto it = map_.find(key);
+          return it == map_.end() ? nullptr : &it->second;
+      }
+
+      bool contains(std::string_view key) const { return map_.find(key) != map_.end(); }
+
+      bool erase(std::string_view key) {
+          auto it = map_.find(key);
+          if (it == map_.end()) {
+              return false;
+          }
+          map_.erase(it);
+          return true;
+      }
+
+      std::size_t size() const { return map_.size(); }
+      void reserve(std::size_t) {}  // Nodes are allocated one by one anyway
+      void clear() { map_.clear(); }
+
+      template <typename F>
+      void forEachOrdered(F&& visit) {
+          for (auto& [key, value] : map_) {
+              visit(std::string_view(key), value);
+          }
+      }
+
+  private:
+      std::map<std::string, V, std::less<>> map_;
+};
+
+static_assert(StringMap<FlatHashMap<int>>);
+static_assert(StringMap<SortedVectorMap<int>>);
+static_assert(StringMap<StdMap<int>>);
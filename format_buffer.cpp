@@ -0,0 +1,78 @@
+#include "format_buffer.h"
+
+#include <charconv>
+#include <cstring>
+
+char* FormatBuffer::reserve(std::size_t count) {
+    if (storage_.size() - size_ < count) {
+        std::size_t capacity = storage_.size();
+        while (capacity - size_ < count) {
+            capacity *= 2;
+        }
+        storage_.resize(capacity);
+    }
+    return storage_.data() + size_;
+}
+
+FormatBuffer& FormatBuffer::append(std::string_view text) {
+    std::memcpy(reserve(text.size()), text.data(), text.size());
+    size_ += text.size();
+    return *this;
+}
+
+FormatBuffer& FormatBuffer::append(char c) {
+    *reserve(1) = c;
+    size_++;
+    return *this;
+}
+
+FormatBuffer& FormatBuffer::appendInt(long long value) {
+    constexpr std::size_t kMaxDigits = 20;
+    char* first = reserve(kMaxDigits);
+    size_ = static_cast<std::size_t>(std::to_chars(first, first + kMaxDigits, value).ptr - storage_.data());
+    return *this;
+}
+
+FormatBuffer& FormatBuffer::appendHex(unsigned long long value) {
+    // showbase prints no prefix for zero
+    if (value != 0) {
+        append("0x");
+    }
+    constexpr std::size_t kMaxDigits = 16;
+    char* first = reserve(kMaxDigits);
+    size_ = static_cast<std::size_t>(std::to_chars(first, first + kMaxDigits, value, 16).ptr - storage_.data());
+    return *this;
+}
+
+FormatBuffer& FormatBuffer::appendFixed(double value, int precision) {
+    // The largest double has 309 integer digits
+    std::size_t room = 312 + static_cast<std::size_t>(precision);
+    char* first = reserve(room);
+    size_ = static_cast<std::size_t>(
+        std::to_chars(first, first + room, value, std::chars_format::fixed, precision).ptr - storage_.data());
+    return *this;
+}
+
+FormatBuffer& FormatBuffer::appendScientific(double value, int precision) {
+    std::size_t room = 8 + static_cast<std::size_t>(precision);
+    char* first = reserve(room);
+    size_ = static_cast<std::size_t>(
+        std::to_chars(first, first + room, value, std::chars_format::scientific, precision).ptr - storage_.data());
+    return *this;
+}
+
+FormatBuffer& threadFormatBuffer() {
+    thread_local FormatBuffer buffer;
+    buffer.clear();
+    return buffer;
+}
+
+void appendNumberTable(FormatBuffer& out, std::span<const NumberRow> rows, int precision) {
+    for (const NumberRow& row : rows) {
+        // std::hex shows the bits of the int, so negative values print as unsigned
+        out.append("   Hex: ").appendHex(static_cast<unsigned>(row.integer));
+        out.append("\n   Decimal: ").appendInt(row.integer);
+        out.append("\n   Fixed precision: ").appendFixed(row.real, precision);
+        out.append("\n   Scientific: ").appendScientific(row.real, precision).append('\n');
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+/*
+ * Formatting into a reusable buffer instead of a fresh std::string per
+ * line (similar to reusing one StringBuilder in C#, or to building a line
+ * in a preallocated Buffer in Node.js).
+ *
+ * std::format returns a new string on every call and ostringstream::str()
+ * copies its contents into one; both allocate for every record. A
+ * FormatBuffer keeps its storage between lines: once it has grown to the
+ * longest line, formatting allocates nothing.
+ *
+ *     FormatBuffer& line = threadFormatBuffer();
+ *     line.append("Value=").appendInt(num).append(", Pi=").appendFixed(pi, 2).append('\n');
+ *     line.writeTo(out);
+ *
+ * The append* functions use std::to_chars and produce the same text as the
+ * matching stream manipulators. With <format> there is also format(),
+ * which runs std::format_to_n straight into the free space and only grows
+ * the buffer (then formats again) when the text does not fit.
+ */
+class FormatBuffer {
+  public:
+      static constexpr std::size_t kInitialCapacity = 256;
+
+      FormatBuffer() : storage_(kInitialCapacity) {}
+
+      FormatBuffer& append(std::string_view text);
+      FormatBuffer& append(char c);
+      FormatBuffer& appendInt(long long value);                     // Like `os << value`
+      FormatBuffer& appendHex(unsigned long long value);            // std::hex << std::showbase: 0x2a
+      FormatBuffer& appendFixed(double value, int precision);       // std::fixed << std::setprecision
+      FormatBuffer& appendScientific(double value, int precision);  // std::scientific << std::setprecision
+
+#if defined(__cpp_lib_format)
+      template <typename... Args>
+      FormatBuffer& format(std::format_string<Args...> fmt, Args&&... args) {
+          std::size_t room = storage_.size() - size_;
+          auto result = std::format_to_n(storage_.data() + size_, room, fmt, std::forward<Args>(args)...);
+          auto length = static_cast<std::size_t>(result.size);
+          if (length > room) {
+              std::format_to(reserve(length), fmt, std::forward<Args>(args)...);
+          }
+          size_ += length;
+          return *this;
+      }
+#endif
+
+      std::string_view view() const { return {storage_.data(), size_}; }
+      std::size_t size() const { return size_; }
+      std::size_t capacity() const { return storage_.size(); }
+
+      // Keeps the storage for the next line
+      void clear() { size_ = 0; }
+
+      // One write of everything formatted so far (into an OutputSink this is a memcpy)
+      void writeTo(std::ostream& os) const { os.write(storage_.data(), static_cast<std::streamsize>(size_)); }
+
+  private:
+      // Room for `count` more characters; returns where they go
+      char* reserve(std::size_t count);
+
+      std::vector<char> storage_;
+      std::size_t size_ = 0;
+};
+
+// The calling thread's buffer, cleared. Fill and write it one line (or one
+// batch of lines) at a time: anything that calls threadFormatBuffer() again
+// before it is written clears it.
+FormatBuffer& threadFormatBuffer();
+
+// ----- Number tables -----
+
+// One row of the table in demonstrateModernIO's "Formatted output with
+// manipulators": an int in hex and decimal, a double in fixed and
+// scientific notation
+struct NumberRow {
+    int integer;
+    double real;
+};
+
+// Appends four lines per row, the same text as the manipulator version:
+//    Hex: 0x2a
+//    Decimal: 42
+//    Fixed precision: 3.14
+//    Scientific: 3.14e+00
+// No stream state is touched, and the whole table comes out of one buffer,
+// ready to be written in one call.
+void appendNumberTable(FormatBuffer& out, std::span<const NumberRow> rows, int precision = 2);
@@ -0,0 +1,246 @@
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <iomanip>
+
+#if __has_include(<unistd.h>) && __has_include(<fcntl.h>)
+#include <fcntl.h>
+#include <unistd.h>
+#define MYPROJECT_HAS_TRACE_MARKERS 1
+#else
+#define MYPROJECT_HAS_TRACE_MARKERS 0
+#endif
+
+namespace instrumentation {
+
+namespace {
+
+double microseconds(Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+struct Totals {
+    double durationMicroseconds = 0;
+    AllocationCounts allocations;
+};
+
+Totals totalOf(const std::vector<SectionStats>& sections) {
+    Totals totals;
+    for (const SectionStats& s : sections) {
+        totals.durationMicroseconds += s.durationMicroseconds;
+        totals.allocations.allocations += s.allocations.allocations;
+        totals.allocations.frees += s.allocations.frees;
+        totals.allocations.bytes += s.allocations.bytes;
+    }
+    return totals;
+}
+
+}
+
+StatsCollector::StatsCollector() : epoch_(Clock::now()) {}
+
+StatsCollector::~StatsCollector() {
+#if MYPROJECT_HAS_TRACE_MARKERS
+    if (markerFd_ >= 0) {
+        ::close(markerFd_);
+    }
+#endif
+}
+
+StatsCollector& StatsCollector::global() {
+    static StatsCollector collector;
+    return collector;
+}
+
+unsigned StatsCollector::threadIndex() {
+    thread_local unsigned index = UINT_MAX;
+    if (index == UINT_MAX) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index = nextThread_++;
+    }
+    return index;
+}
+
+void StatsCollector::nameThread(std::string_view name) {
+    unsigned thread = threadIndex();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (threadNames_.size() <= thread) {
+        threadNames_.resize(thread + 1);
+    }
+    threadNames_[thread] = std::string(name);
+}
+
+void StatsCollector::recordTask(Clock::time_point start, Clock::time_point stop) {
+    TaskSpan span{threadIndex(), microseconds(start - epoch_), microseconds(stop - start)};
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(span);
+}
+
+bool StatsCollector::enableMarkers() {
+#if MYPROJECT_HAS_TRACE_MARKERS
+    if (markerFd_ < 0) {
+        for (const char* path : {"/sys/kernel/tracing/trace_marker", "/sys/kernel/debug/tracing/trace_marker"}) {
+            markerFd_ = ::open(path, O_WRONLY | O_CLOEXEC);
+            if (markerFd_ >= 0) {
+                break;
+            }
+        }
+    }
+    return markerFd_ >= 0;
+#else
+    return false;
+#endif
+}
+
+void StatsCollector::beginMarker(std::string_view name) {
+#if MYPROJECT_HAS_TRACE_MARKERS
+    // One write() per marker: the kernel takes each write as a single event
+    char text[256];
+    int length = std::snprintf(text, sizeof(text), "B|%d|%.*s", static_cast<int>(::getpid()),
+                               static_cast<int>(name.size()), name.data());
+    if (length > 0) {
+        [[maybe_unused]] ssize_t written = ::write(markerFd_, text, std::min<std::size_t>(length, sizeof(text) - 1));
+    }
+#else
+    (void)name;
+#endif
+}
+
+void StatsCollector::endMarker() {
+#if MYPROJECT_HAS_TRACE_MARKERS
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "E|%d", static_cast<int>(::getpid()));
+    if (length > 0) {
+        [[maybe_unused]] ssize_t written = ::write(markerFd_, text, static_cast<std::size_t>(length));
+    }
+#endif
+}
+
+void StatsCollector::record(std::string_view name, Clock::time_point start, Clock::time_point stop,
+                            const AllocationCounts& allocations) {
+    unsigned thread = threadIndex();
+    SectionStats stats{std::string(name), thread, microseconds(start - epoch_), microseconds(stop - start), allocations};
+    std::lock_guard<std::mutex> lock(mutex_);
+    sections_.push_back(std::move(stats));
+}
+
+std::vector<SectionStats> StatsCollector::sections() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sections_;
+}
+
+void StatsCollector::printSummary(std::ostream& os) const {
+    std::vector<SectionStats> snapshot = sections();
+    Totals totals = totalOf(snapshot);
+    auto row = [&os](std::string_view name, double us, const AllocationCounts& a) {
+        os << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(1)
+           << std::setw(12) << us << std::setw(10) << a.allocations << std::setw(10) << a.frees
+           << std::setw(12) << a.bytes << '\n';
+    };
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::left << std::setw(26) << "section" << std::right << std::setw(12) << "time (us)"
+       << std::setw(10) << "allocs" << std::setw(10) << "frees" << std::setw(12) << "bytes" << '\n';
+    for (const SectionStats& s : snapshot) {
+        row(s.name, s.durationMicroseconds, s.allocations);
+    }
+    row("total", totals.durationMicroseconds, totals.allocations);
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void StatsCollector::writeJson(std::ostream& os) const {
+    std::vector<SectionStats> snapshot = sections();
+    Totals totals = totalOf(snapshot);
+    auto counts = [&os](const AllocationCounts& a) {
+        os << "\"allocations\": " << a.allocations << ", \"frees\": " << a.frees << ", \"bytes\": " << a.bytes;
+    };
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(3) << "{\n  \"sections\": [";
+    for (std::size_t i = 0; i < snapshot.size(); i++) {
+        const SectionStats& s = snapshot[i];
+        os << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        writeJsonString(os, s.name);
+        os << ", \"thread\": " << s.thread << ", \"start_us\": " << s.startMicroseconds
+           << ", \"duration_us\": " << s.durationMicroseconds << ", ";
+        counts(s.allocations);
+        os << '}';
+    }
+    os << "\n  ],\n  \"total\": {\"duration_us\": " << totals.durationMicroseconds << ", ";
+    counts(totals.allocations);
+    os << "}\n}\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void StatsCollector::writeChromeTrace(std::ostream& os) const {
+    std::vector<SectionStats> sectionsCopy;
+    std::vector<TaskSpan> tasksCopy;
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sectionsCopy = sections_;
+        tasksCopy = tasks_;
+        names = threadNames_;
+    }
+    std::ios_base::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+    os << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    auto next = [&os, &first] {
+        os << (first ? "\n" : ",\n");
+        first = false;
+    };
+    for (std::size_t thread = 0; thread < names.size(); thread++) {
+        if (!names[thread].empty()) {
+            next();
+            os << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread
+               << ", \"args\": {\"name\": ";
+            writeJsonString(os, names[thread]);
+            os << "}}";
+        }
+    }
+    for (const SectionStats& s : sectionsCopy) {
+        next();
+        os << "{\"name\": ";
+        writeJsonString(os, s.name);
+        os << ", \"cat\": \"section\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << s.thread
+           << ", \"ts\": " << s.startMicroseconds << ", \"dur\": " << s.durationMicroseconds
+           << ", \"args\": {\"allocations\": " << s.allocations.allocations
+           << ", \"bytes\": " << s.allocations.bytes << "}}";
+    }
+    for (const TaskSpan& t : tasksCopy) {
+        next();
+        os << "{\"name\": \"task\", \"cat\": \"worker\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << t.thread
+           << ", \"ts\": " << t.startMicroseconds << ", \"dur\": " << t.durationMicroseconds << "}";
+    }
+    os << "\n]}\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+void writeJsonString(std::ostream& os, std::string_view text) {
+    os << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n"; break;
+            case '\t': os << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    os << escaped;
+                } else {
+                    os << c;
+                }
+        }
+    }
+    os << '"';
+}
+
+}
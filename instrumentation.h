@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "alloc_counter.h"
+
+/*
+ * Per-section timing and allocation counts for the tutorial binary.
+ *
+ * SectionScope is a RAII timer (similar to a Stopwatch in a using block in
+ * C#): it measures the wall time and the heap allocations made by the
+ * current thread from its construction to its destruction, and records
+ * them in the process-wide StatsCollector.
+ *
+ * The same records can be written as a Chrome trace (--trace, for
+ * chrome://tracing or Perfetto), together with a span for every task the
+ * worker threads run. --perf-markers also writes section boundaries into
+ * the kernel's ftrace marker file, so `perf` and Perfetto system traces
+ * show them next to everything else on the machine.
+ *
+ * Everything hangs off the MYPROJECT_INSTRUMENTATION build option
+ * (CMakeLists.txt). Without it SectionScope is an empty class whose
+ * constructor does nothing, operator new is not replaced, and the
+ * compiler removes every trace of it.
+ */
+namespace instrumentation {
+
+#if defined(MYPROJECT_INSTRUMENTATION)
+inline constexpr bool kEnabled = true;
+#else
+inline constexpr bool kEnabled = false;
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+struct SectionStats {
+    std::string name;
+    unsigned thread = 0;              // Small index of the thread that ran it (0 = the first one seen)
+    double startMicroseconds = 0;     // From the collector's creation
+    double durationMicroseconds = 0;
+    AllocationCounts allocations;
+};
+
+// One task run by a worker thread (recorded only while tracing)
+struct TaskSpan {
+    unsigned thread = 0;
+    double startMicroseconds = 0;
+    double durationMicroseconds = 0;
+};
+
+class StatsCollector {
+  public:
+      StatsCollector();
+      ~StatsCollector();
+
+      StatsCollector(const StatsCollector&) = delete;
+      StatsCollector& operator=(const StatsCollector&) = delete;
+
+      static StatsCollector& global();
+
+      // Thread-safe; sections running in parallel record concurrently
+      void record(std::string_view name, Clock::time_point start, Clock::time_point stop,
+                  const AllocationCounts& allocations);
+
+      // Snapshot in the order sections finished
+      std::vector<SectionStats> sections() const;
+
+      // A small index per thread, in the order threads first record
+      unsigned threadIndex();
+
+      // Names the calling thread in traces ("main", "worker 3", ...)
+      void nameThread(std::string_view name);
+
+      // Task spans are only kept after enableTracing()
+      void enableTracing() { tracing_.store(true, std::memory_order_relaxed); }
+      bool tracing() const { return tracing_.load(std::memory_order_relaxed); }
+      void recordTask(Clock::time_point start, Clock::time_point stop);
+
+      // Opens the ftrace marker file; false if it is not available
+      // (tracefs not mounted, no permission, not Linux)
+      bool enableMarkers();
+      bool markers() const { return markerFd_ >= 0; }
+      // "B|pid|name" opens a slice and "E|pid" closes it (the atrace format)
+      void beginMarker(std::string_view name);
+      void endMarker();
+
+      Clock::time_point epoch() const { return epoch_; }
+
+      // A table with one row per section and a total
+      void printSummary(std::ostream& os) const;
+
+      // {"sections": [{"name", "thread", "start_us", "duration_us",
+      //  "allocations", "frees", "bytes"}, ...], "total": {...}}
+      void writeJson(std::ostream& os) const;
+
+      // Chrome Trace Event format: a complete ("X") event per section and
+      // per task, plus thread names. Times are in microseconds.
+      void writeChromeTrace(std::ostream& os) const;
+
+  private:
+      mutable std::mutex mutex_;
+      Clock::time_point epoch_;
+      std::vector<SectionStats> sections_;
+      std::vector<TaskSpan> tasks_;
+      std::vector<std::string> threadNames_;  // By thread index, may be empty
+      unsigned nextThread_ = 0;
+      std::atomic<bool> tracing_{false};
+      int markerFd_ = -1;
+};
+
+// Writes text as a JSON string literal, quotes included
+void writeJsonString(std::ostream& os, std::string_view text);
+
+// Measures one section, recorded when it goes out of scope
+class ActiveSectionScope {
+  public:
+      // The collector is fetched first, so its epoch precedes every start
+      explicit ActiveSectionScope(std::string_view name)
+          : collector_(StatsCollector::global()), name_(name),
+            allocations_(threadAllocationCounts()), start_(Clock::now()) {
+          if (collector_.markers()) {
+              collector_.beginMarker(name_);
+          }
+      }
+
+      ~ActiveSectionScope() {
+          Clock::time_point stop = Clock::now();
+          if (collector_.markers()) {
+              collector_.endMarker();
+          }
+          collector_.record(name_, start_, stop, threadAllocationCounts() - allocations_);
+      }
+
+      ActiveSectionScope(const ActiveSectionScope&) = delete;
+      ActiveSectionScope& operator=(const ActiveSectionScope&) = delete;
+
+  private:
+      StatsCollector& collector_;
+      std::string_view name_;
+      AllocationCounts allocations_;
+      Clock::time_point start_;
+};
+
+// The disabled policy: nothing to store and nothing to do
+class NoSectionScope {
+  public:
+      explicit NoSectionScope(std::string_view) {}
+};
+
+// Measures one task on a worker thread, when tracing is on
+class ActiveTaskScope {
+  public:
+      ActiveTaskScope() : collector_(StatsCollector::global()) {
+          if (collector_.tracing()) {
+              start_ = Clock::now();
+          }
+      }
+
+      ~ActiveTaskScope() {
+          if (start_ != Clock::time_point{}) {
+              collector_.recordTask(start_, Clock::now());
+          }
+      }
+
+      ActiveTaskScope(const ActiveTaskScope&) = delete;
+      ActiveTaskScope& operator=(const ActiveTaskScope&) = delete;
+
+  private:
+      StatsCollector& collector_;
+      Clock::time_point start_{};
+};
+
+class NoTaskScope {
+  public:
+      NoTaskScope() {}   // User-provided, so `TaskScope scope;` is not an unused variable
+};
+
+#if defined(MYPROJECT_INSTRUMENTATION)
+using SectionScope = ActiveSectionScope;
+using TaskScope = ActiveTaskScope;
+#else
+using SectionScope = NoSectionScope;
+using TaskScope = NoTaskScope;
+#endif
+
+// Names the calling thread in traces; nothing when instrumentation is off
+inline void nameThread([[maybe_unused]] std::string_view name) {
+    if constexpr (kEnabled) {
+        StatsCollector::global().nameThread(name);
+    }
+}
+
+}
@@ -0,0 +1,76 @@
+#include "interned_string.h"
+
+#include <cstring>
+#include <stdexcept>
+
+SharedStringPool::SharedStringPool()
+    : pages_(std::make_unique<std::atomic<const std::string_view*>[]>(kMaxPages)) {
+    intern("");
+}
+
+SharedStringPool& SharedStringPool::global() {
+    static SharedStringPool pool;
+    return pool;
+}
+
+// Copies text into the current block. Long strings get a block of their
+// own, so they do not leave the rest of a shared block unused.
+std::string_view SharedStringPool::store(std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+    char* destination;
+    if (text.size() > kBlockSize / 4) {
+        blocks_.push_back(std::make_unique_for_overwrite<char[]>(text.size()));
+        characterBytes_ += text.size();
+        destination = blocks_.back().get();
+    } else {
+        if (current_ == nullptr || kBlockSize - blockUsed_ < text.size()) {
+            blocks_.push_back(std::make_unique_for_overwrite<char[]>(kBlockSize));
+            characterBytes_ += kBlockSize;
+            current_ = blocks_.back().get();
+            blockUsed_ = 0;
+        }
+        destination = current_ + blockUsed_;
+        blockUsed_ += text.size();
+    }
+    std::memcpy(destination, text.data(), text.size());
+    return {destination, text.size()};
+}
+
+SharedStringPool::Id SharedStringPool::intern(std::string_view text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(text);
+    if (found != index_.end()) {
+        return found->second;
+    }
+    if (size_ == 0xFFFFFFFFu) {
+        throw std::length_error("SharedStringPool: too many strings for 32-bit ids");
+    }
+    const Id id = size_;
+    std::size_t page = id >> kPageBits;
+    if ((id & (kPageSize - 1)) == 0) {
+        ownedPages_.push_back(std::make_unique<std::string_view[]>(kPageSize));
+        pages_[page].store(ownedPages_.back().get(), std::memory_order_release);
+    }
+    std::string_view stored = store(text);
+    // The page is only written under the lock, and a reader only asks for
+    // ids it was given after intern() returned
+    ownedPages_[page][id & (kPageSize - 1)] = stored;
+    index_.emplace(stored, id);
+    size_++;
+    return id;
+}
+
+std::size_t SharedStringPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+std::size_t SharedStringPool::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The index is approximated as one node plus one bucket per entry
+    return characterBytes_ + kMaxPages * sizeof(pages_[0]) + ownedPages_.size() * kPageSize * sizeof(std::string_view)
+         + index_.size() * (sizeof(std::string_view) + sizeof(Id) + 2 * sizeof(void*))
+         + index_.bucket_count() * sizeof(void*);
+}
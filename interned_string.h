@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * A process-wide, deduplicating string table shared by every thread.
+ *
+ * Unlike StringPool (string_pool.h), which belongs to a single table and
+ * may move its characters when it grows, strings in a SharedStringPool
+ * never move and are never freed. So a 32-bit id is all an object needs to
+ * keep, and view(id) can be read from any thread without a lock. Only
+ * intern() takes the mutex.
+ */
+class SharedStringPool {
+  public:
+      using Id = std::uint32_t;
+
+      static constexpr Id kEmpty = 0;  // "" is always id 0
+
+      SharedStringPool();
+
+      SharedStringPool(const SharedStringPool&) = delete;
+      SharedStringPool& operator=(const SharedStringPool&) = delete;
+
+      // The pool used by InternedString
+      static SharedStringPool& global();
+
+      // Returns the id of `text`, adding it if it is new. Thread-safe.
+      Id intern(std::string_view text);
+
+      // Lock-free; the view stays valid for the life of the pool
+      std::string_view view(Id id) const {
+          const std::string_view* page = pages_[id >> kPageBits].load(std::memory_order_acquire);
+          return page[id & (kPageSize - 1)];
+      }
+
+      std::size_t size() const;
+
+      // Bytes held by the pool (characters, id directory and the index)
+      std::size_t memoryUsage() const;
+
+  private:
+      static constexpr unsigned kPageBits = 16;
+      static constexpr std::size_t kPageSize = std::size_t{1} << kPageBits;   // Views per page
+      static constexpr std::size_t kMaxPages = std::size_t{1} << (32 - kPageBits);
+      static constexpr std::size_t kBlockSize = 64 * 1024;                  // Characters per block
+
+      std::string_view store(std::string_view text);
+
+      mutable std::mutex mutex_;
+      // Id -> view, in fixed pages so a reader never sees a vector reallocate
+      std::unique_ptr<std::atomic<const std::string_view*>[]> pages_;
+      std::vector<std::unique_ptr<std::string_view[]>> ownedPages_;
+      std::vector<std::unique_ptr<char[]>> blocks_;
+      char* current_ = nullptr;   // Block that short strings are appended to
+      std::size_t blockUsed_ = 0;
+      std::size_t characterBytes_ = 0;
+      std::unordered_map<std::string_view, Id> index_;  // Keys point into blocks_
+      Id size_ = 0;
+};
+
+// A string stored as a 32-bit id into SharedStringPool::global(). Copying
+// one copies 4 bytes, and equal strings compare equal by id. Similar in
+// spirit to string.Intern in C#, where equal interned strings are one object.
+class InternedString {
+  public:
+      InternedString() = default;
+      explicit InternedString(std::string_view text) : id_(SharedStringPool::global().intern(text)) {}
+
+      std::string_view view() const { return SharedStringPool::global().view(id_); }
+      SharedStringPool::Id id() const { return id_; }
+      bool empty() const { return id_ == SharedStringPool::kEmpty; }
+
+      friend bool operator==(InternedString a, InternedString b) { return a.id_ == b.id_; }
+
+  private:
+      SharedStringPool::Id id_ = SharedStringPool::kEmpty;
+};
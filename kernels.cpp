@@ -0,0 +1,273 @@
+#include "kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#else
+#define KERNELS_X86 0
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define KERNELS_NEON 1
+#include <arm_neon.h>
+#else
+#define KERNELS_NEON 0
+#endif
+
+namespace kernels {
+
+namespace {
+
+// ----- Scalar fallbacks (also used for the tail of every SIMD loop) -----
+
+inline std::int32_t doubled(std::int32_t x) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) << 1);
+}
+
+void doubleScalar(const std::int32_t* in, std::int32_t* out, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+        out[i] = doubled(in[i]);
+    }
+}
+
+std::size_t findScalar(const std::int32_t* values, std::size_t n, std::int32_t needle) {
+    for (std::size_t i = 0; i < n; i++) {
+        if (values[i] == needle) {
+            return i;
+        }
+    }
+    return n;
+}
+
+#if KERNELS_X86
+// The target attribute lets one function use AVX2 even though the rest of
+// the file is compiled for the baseline x86-64 instruction set
+
+__attribute__((target("sse4.2")))
+void doubleSse42(const std::int32_t* in, std::int32_t* out, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_slli_epi32(v, 1));
+    }
+    doubleScalar(in + i, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+void doubleAvx2(const std::int32_t* in, std::int32_t* out, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_slli_epi32(a, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 8), _mm256_slli_epi32(b, 1));
+    }
+    doubleScalar(in + i, out + i, n - i);
+}
+
+__attribute__((target("sse4.2")))
+std::size_t findSse42(const std::int32_t* values, std::size_t n, std::int32_t needle) {
+    const __m128i wanted = _mm_set1_epi32(needle);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, wanted)));
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+    return i + findScalar(values + i, n - i, needle);
+}
+
+__attribute__((target("avx2")))
+std::size_t findAvx2(const std::int32_t* values, std::size_t n, std::int32_t needle) {
+    const __m256i wanted = _mm256_set1_epi32(needle);
+    std::size_t i = 0;
+    // Two vectors per iteration, combined so the loop has a single branch
+    for (; i + 16 <= n; i += 16) {
+        __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)), wanted);
+        __m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 8)), wanted);
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_or_si256(a, b))) {
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(a)))
+                          | static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(b))) << 8;
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+    return i + findScalar(values + i, n - i, needle);
+}
+#endif
+
+#if KERNELS_NEON
+void doubleNeon(const std::int32_t* in, std::int32_t* out, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_s32(out + i, vshlq_n_s32(vld1q_s32(in + i), 1));
+    }
+    doubleScalar(in + i, out + i, n - i);
+}
+
+std::size_t findNeon(const std::int32_t* values, std::size_t n, std::int32_t needle) {
+    const int32x4_t wanted = vdupq_n_s32(needle);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t equal = vceqq_s32(vld1q_s32(values + i), wanted);
+        if (vmaxvq_u32(equal) != 0) {
+            return i + findScalar(values + i, 4, needle);
+        }
+    }
+    return i + findScalar(values + i, n - i, needle);
+}
+#endif
+
+Isa detectIsa() {
+#if KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return Isa::Sse42;
+    }
+#elif KERNELS_NEON
+    return Isa::Neon;  // Always present on AArch64
+#endif
+    return Isa::Scalar;
+}
+
+void requireSupported(Isa isa) {
+    if (!isSupported(isa)) {
+        throw std::invalid_argument(std::string("instruction set not supported here: ") + isaName(isa));
+    }
+}
+
+}
+
+Isa bestIsa() {
+    static const Isa best = detectIsa();
+    return best;
+}
+
+bool isSupported(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar:
+            return true;
+        case Isa::Sse42:
+            return KERNELS_X86 && bestIsa() != Isa::Scalar;
+        case Isa::Avx2:
+            return KERNELS_X86 && bestIsa() == Isa::Avx2;
+        case Isa::Neon:
+            return KERNELS_NEON != 0;
+    }
+    return false;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::Sse42: return "SSE4.2";
+        case Isa::Avx2: return "AVX2";
+        case Isa::Neon: return "NEON";
+    }
+    return "unknown";
+}
+
+void doubleValues(std::span<const std::int32_t> in, std::span<std::int32_t> out) {
+    doubleValues(bestIsa(), in, out);
+}
+
+void doubleValues(Isa isa, std::span<const std::int32_t> in, std::span<std::int32_t> out) {
+    if (out.size() < in.size()) {
+        throw std::invalid_argument("doubleValues: output is shorter than input");
+    }
+    requireSupported(isa);
+    switch (isa) {
+#if KERNELS_X86
+        case Isa::Avx2:
+            return doubleAvx2(in.data(), out.data(), in.size());
+        case Isa::Sse42:
+            return doubleSse42(in.data(), out.data(), in.size());
+#endif
+#if KERNELS_NEON
+        case Isa::Neon:
+            return doubleNeon(in.data(), out.data(), in.size());
+#endif
+        default:
+            return doubleScalar(in.data(), out.data(), in.size());
+    }
+}
+
+std::size_t findValue(std::span<const std::int32_t> values, std::int32_t needle) {
+    return findValue(bestIsa(), values, needle);
+}
+
+std::size_t findValue(Isa isa, std::span<const std::int32_t> values, std::int32_t needle) {
+    requireSupported(isa);
+    switch (isa) {
+#if KERNELS_X86
+        case Isa::Avx2:
+            return findAvx2(values.data(), values.size(), needle);
+        case Isa::Sse42:
+            return findSse42(values.data(), values.size(), needle);
+#endif
+#if KERNELS_NEON
+        case Isa::Neon:
+            return findNeon(values.data(), values.size(), needle);
+#endif
+        default:
+            return findScalar(values.data(), values.size(), needle);
+    }
+}
+
+// LSD radix sort, one byte per pass. Flipping the sign bit maps int32 to
+// uint32 with the same order, so negative numbers come out first.
+void sortValues(std::span<std::int32_t> values) {
+    const std::size_t n = values.size();
+    if (n < 256) {
+        std::sort(values.begin(), values.end());  // Not worth four passes
+        return;
+    }
+    auto key = [](std::int32_t v) { return static_cast<std::uint32_t>(v) ^ 0x80000000u; };
+
+    // All four histograms in a single read of the input
+    std::array<std::array<std::size_t, 256>, 4> counts{};
+    for (std::int32_t v : values) {
+        std::uint32_t k = key(v);
+        counts[0][k & 0xFF]++;
+        counts[1][(k >> 8) & 0xFF]++;
+        counts[2][(k >> 16) & 0xFF]++;
+        counts[3][k >> 24]++;
+    }
+
+    std::vector<std::int32_t> scratch(n);
+    std::int32_t* from = values.data();
+    std::int32_t* to = scratch.data();
+    for (unsigned pass = 0; pass < 4; pass++) {
+        std::array<std::size_t, 256>& count = counts[pass];
+        const unsigned shift = pass * 8;
+        // Every element has the same byte here: this pass would not move anything
+        if (count[(key(from[0]) >> shift) & 0xFF] == n) {
+            continue;
+        }
+        std::size_t offset = 0;
+        for (std::size_t& c : count) {
+            std::size_t bucket = c;
+            c = offset;
+            offset += bucket;
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            std::int32_t v = from[i];
+            to[count[(key(v) >> shift) & 0xFF]++] = v;
+        }
+        std::swap(from, to);
+    }
+    if (from != values.data()) {
+        std::copy(from, from + n, values.data());
+    }
+}
+
+}
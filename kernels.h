@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/*
+ * Bulk versions of the three STL algorithms in demonstrateStl, for large
+ * arrays of 32-bit ints:
+ *
+ *   doubleValues  ~ std::transform(in, out, [](int x) { return x * 2; })
+ *   findValue     ~ std::find(values, needle)
+ *   sortValues    ~ std::sort(values)
+ *
+ * The transform and the find have explicit SIMD code paths (SSE4.2 and
+ * AVX2 on x86, NEON on ARM). The best one the CPU supports is chosen at
+ * runtime, so one binary runs everywhere. sortValues is an LSD radix sort:
+ * it does not use SIMD instructions, but does O(n) work instead of the
+ * O(n log n) comparisons of std::sort.
+ */
+namespace kernels {
+
+enum class Isa { Scalar, Sse42, Avx2, Neon };
+
+// The best instruction set this CPU supports (detected once)
+Isa bestIsa();
+bool isSupported(Isa isa);
+const char* isaName(Isa isa);
+
+// Doubling wraps around on overflow (like unsigned arithmetic), instead of
+// being undefined behaviour. `out` must be at least as long as `in`.
+void doubleValues(std::span<const std::int32_t> in, std::span<std::int32_t> out);
+void doubleValues(Isa isa, std::span<const std::int32_t> in, std::span<std::int32_t> out);
+
+// Index of the first element equal to needle, or values.size() if absent
+std::size_t findValue(std::span<const std::int32_t> values, std::int32_t needle);
+std::size_t findValue(Isa isa, std::span<const std::int32_t> values, std::int32_t needle);
+
+// Ascending order, same result as std::sort. Needs a temporary buffer of
+// the same size (allocated internally).
+void sortValues(std::span<std::int32_t> values);
+
+}
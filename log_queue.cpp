@@ -0,0 +1,357 @@
+#include "log_queue.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#include "output_sink.h"
+
+namespace {
+
+constexpr std::size_t kMinCapacity = 128;
+constexpr std::size_t kBatchSize = 64 * 1024;   // The drainer writes in batches of about this size
+
+std::atomic<std::uint64_t> nextQueueId{1};
+std::atomic<LogQueue*> installedQueue{nullptr};
+
+}
+
+BackPressure parseBackPressure(std::string_view name) {
+    if (name == "block") {
+        return BackPressure::Block;
+    }
+    if (name == "drop") {
+        return BackPressure::Drop;
+    }
+    if (name == "spill") {
+        return BackPressure::Spill;
+    }
+    throw std::invalid_argument("unknown back-pressure policy '" + std::string(name) + "' (block, drop or spill)");
+}
+
+const char* backPressureName(BackPressure policy) {
+    switch (policy) {
+        case BackPressure::Block: return "block";
+        case BackPressure::Drop: return "drop";
+        case BackPressure::Spill: return "spill";
+    }
+    return "unknown";
+}
+
+LogQueue::LogQueue(std::ostream& destination, BackPressure policy, std::size_t capacity)
+    : destination_(destination),
+      policy_(policy),
+      id_(nextQueueId.fetch_add(1, std::memory_order_relaxed)),
+      mask_(std::bit_ceil(std::max(capacity, kMinCapacity)) - 1),
+      slots_(new Slot[mask_ + 1]) {
+    for (std::size_t i = 0; i <= mask_; i++) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    drainer_ = std::thread([this] { drainLoop(); });
+}
+
+LogQueue::~LogQueue() {
+    stopping_.store(true, std::memory_order_release);
+    wakeDrainer(true);
+    drainer_.join();
+}
+
+std::size_t LogQueue::slotsFor(std::size_t length) {
+    return (kHeader + length + kPayload - 1) / kPayload;
+}
+
+// ----- Producers -----
+
+bool LogQueue::push(std::string_view record) {
+    record = record.substr(0, kMaxRecord);
+    if (policy_ == BackPressure::Spill) {
+        return pushSpilling(record);
+    }
+    while (!tryPush(record)) {
+        if (policy_ == BackPressure::Drop) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        wakeDrainer(true);
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+bool LogQueue::tryPush(std::string_view record) {
+    const std::size_t count = slotsFor(record.size());
+    std::uint64_t position = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+        // All `count` slots must be free for this lap. A slot behind its
+        // position means the drainer has not read it yet: the ring is full.
+        // One ahead of it means another producer got there first.
+        bool claimable = true;
+        for (std::size_t i = 0; i < count; i++) {
+            std::uint64_t sequence = slot(position + i).sequence.load(std::memory_order_acquire);
+            if (sequence != position + i) {
+                if (static_cast<std::int64_t>(sequence - (position + i)) < 0) {
+                    return false;
+                }
+                claimable = false;
+                break;
+            }
+        }
+        if (!claimable) {
+            position = tail_.load(std::memory_order_relaxed);
+        } else if (tail_.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // The slots are ours: fill them and publish each one
+    const auto length = static_cast<std::uint32_t>(record.size());
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        Slot& s = slot(position + i);
+        char* data = s.data;
+        std::size_t room = kPayload;
+        if (i == 0) {
+            std::memcpy(data, &length, kHeader);
+            data += kHeader;
+            room -= kHeader;
+        }
+        std::size_t chunk = std::min(room, record.size() - offset);
+        std::memcpy(data, record.data() + offset, chunk);
+        offset += chunk;
+        s.sequence.store(position + i + 1, std::memory_order_release);
+    }
+    wakeDrainer(false);
+    return true;
+}
+
+// Once a thread has records in its spill buffer, everything else it pushes
+// goes there too until the drainer has taken them, so its order is kept
+bool LogQueue::pushSpilling(std::string_view record) {
+    SpillBuffer* buffer = findSpillBuffer();
+    for (;;) {
+        if (buffer == nullptr || !buffer->pending.load(std::memory_order_acquire)) {
+            if (tryPush(record)) {
+                return true;
+            }
+            if (buffer == nullptr) {
+                buffer = &createSpillBuffer();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            if (buffer->records.empty() || buffer->bytes + record.size() <= kSpillLimit) {
+                buffer->records.emplace_back(record);
+                buffer->bytes += record.size();
+                buffer->pending.store(true, std::memory_order_release);
+                spillRecords_.fetch_add(1, std::memory_order_release);
+                spilledTotal_.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+        // The spill buffer is full as well: wait for the drainer to take it
+        wakeDrainer(true);
+        std::this_thread::yield();
+    }
+    wakeDrainer(false);
+    return true;
+}
+
+std::vector<std::pair<std::uint64_t, LogQueue::SpillBuffer*>>& LogQueue::threadSpills() {
+    // Ids are never reused, so entries of queues that are gone never match
+    thread_local std::vector<std::pair<std::uint64_t, SpillBuffer*>> spills;
+    return spills;
+}
+
+LogQueue::SpillBuffer* LogQueue::findSpillBuffer() {
+    for (const auto& [queue, buffer] : threadSpills()) {
+        if (queue == id_) {
+            return buffer;
+        }
+    }
+    return nullptr;
+}
+
+LogQueue::SpillBuffer& LogQueue::createSpillBuffer() {
+    std::lock_guard<std::mutex> lock(spillsMutex_);
+    SpillBuffer& buffer = *spills_.emplace_back(std::make_unique<SpillBuffer>());
+    threadSpills().emplace_back(id_, &buffer);
+    return buffer;
+}
+
+// Producers only pay for the notification when the drainer is asleep, and
+// only the first one to see it asleep does (until the drainer actually runs
+// again, every push would otherwise make a futex call). The fence pairs
+// with the one in drainLoop: either the producer sees sleeping_, or the
+// drainer sees the new record before it goes to sleep.
+void LogQueue::wakeDrainer(bool always) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool asleep = sleeping_.load(std::memory_order_relaxed)
+                  && sleeping_.exchange(false, std::memory_order_relaxed);
+    if (always || asleep) {
+        signal_.fetch_add(1, std::memory_order_release);
+        signal_.notify_one();
+    }
+}
+
+void LogQueue::flush() {
+    const std::uint64_t target = tail_.load(std::memory_order_acquire);
+    for (;;) {
+        bool spillsWritten = spillRecords_.load(std::memory_order_acquire) == 0;
+        std::uint64_t generation = flushCount_.load(std::memory_order_acquire);
+        flushWanted_.store(true, std::memory_order_release);
+        wakeDrainer(true);
+        flushCount_.wait(generation, std::memory_order_acquire);
+        if (spillsWritten && flushedThrough_.load(std::memory_order_acquire) >= target) {
+            return;
+        }
+    }
+}
+
+// ----- Drainer -----
+
+bool LogQueue::popInto(std::string& batch) {
+    const std::uint64_t position = head_.load(std::memory_order_relaxed);
+    Slot& first = slot(position);
+    if (first.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+    std::uint32_t length = 0;
+    std::memcpy(&length, first.data, kHeader);
+    const std::size_t count = slotsFor(length);
+    std::size_t chunk = std::min<std::size_t>(length, kPayload - kHeader);
+    batch.append(first.data + kHeader, chunk);
+    std::size_t remaining = length - chunk;
+    first.sequence.store(position + capacity(), std::memory_order_release);
+    for (std::size_t i = 1; i < count; i++) {
+        Slot& s = slot(position + i);
+        // Its producer may still be copying into it
+        while (s.sequence.load(std::memory_order_acquire) != position + i + 1) {
+            std::this_thread::yield();
+        }
+        chunk = std::min(kPayload, remaining);
+        batch.append(s.data, chunk);
+        remaining -= chunk;
+        s.sequence.store(position + i + capacity(), std::memory_order_release);
+    }
+    head_.store(position + count, std::memory_order_release);
+    return true;
+}
+
+std::size_t LogQueue::takeSpills(std::string& batch) {
+    std::size_t taken = 0;
+    std::lock_guard<std::mutex> registry(spillsMutex_);
+    for (const std::unique_ptr<SpillBuffer>& buffer : spills_) {
+        if (!buffer->pending.load(std::memory_order_acquire)) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        // The owner's records still in the ring are older than its spilled
+        // ones, so these may only be written once the ring is empty
+        if (tail_.load(std::memory_order_acquire) != head_.load(std::memory_order_relaxed)) {
+            break;
+        }
+        for (const std::string& record : buffer->records) {
+            batch += record;
+        }
+        taken += buffer->records.size();
+        buffer->records.clear();
+        buffer->bytes = 0;
+        buffer->pending.store(false, std::memory_order_release);
+    }
+    return taken;
+}
+
+bool LogQueue::idle() {
+    const std::uint64_t position = head_.load(std::memory_order_relaxed);
+    return slot(position).sequence.load(std::memory_order_acquire) != position + 1
+           && spillRecords_.load(std::memory_order_acquire) == 0
+           && !flushWanted_.load(std::memory_order_acquire)
+           && !stopping_.load(std::memory_order_acquire);
+}
+
+void LogQueue::drainLoop() {
+    std::string batch;
+    batch.reserve(kBatchSize + kMaxRecord);
+    for (;;) {
+        bool progress = false;
+        while (batch.size() < kBatchSize && popInto(batch)) {
+            progress = true;
+        }
+        std::size_t spilled = 0;
+        if (batch.size() < kBatchSize && spillRecords_.load(std::memory_order_acquire) > 0) {
+            spilled = takeSpills(batch);
+        }
+        if (!batch.empty()) {
+            destination_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            batch.clear();
+        }
+        if (spilled > 0) {
+            spillRecords_.fetch_sub(spilled, std::memory_order_release);
+            progress = true;
+        }
+        if (flushWanted_.exchange(false, std::memory_order_acq_rel)) {
+            destination_.flush();
+            flushedThrough_.store(head_.load(std::memory_order_relaxed), std::memory_order_release);
+            flushCount_.fetch_add(1, std::memory_order_release);
+            flushCount_.notify_all();
+        }
+        if (progress) {
+            continue;
+        }
+        if (stopping_.load(std::memory_order_acquire)) {
+            if (spillRecords_.load(std::memory_order_acquire) == 0) {
+                destination_.flush();
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Nothing to do: sleep until a producer, flush() or the destructor signals
+        std::uint32_t seen = signal_.load(std::memory_order_acquire);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (idle()) {
+            signal_.wait(seen, std::memory_order_acquire);
+        } else if (spillRecords_.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();  // Spills waiting for a record still being written
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+// ----- QueuedLogging -----
+
+ScopedLogQueue::ScopedLogQueue(LogQueue& queue)
+    : previous_(installedQueue.exchange(&queue, std::memory_order_acq_rel)) {}
+
+ScopedLogQueue::~ScopedLogQueue() {
+    installedQueue.store(previous_, std::memory_order_release);
+}
+
+LogQueue* currentLogQueue() {
+    return installedQueue.load(std::memory_order_acquire);
+}
+
+void queueLogLine(std::string_view prefix, std::string_view text) {
+    LogQueue* queue = currentLogQueue();
+    if (queue == nullptr) {
+        output() << prefix << text << '\n';
+        return;
+    }
+    // The whole line is one record, formatted on the stack when it fits
+    char line[256];
+    std::size_t length = prefix.size() + text.size() + 1;
+    if (length <= sizeof(line)) {
+        std::memcpy(line, prefix.data(), prefix.size());
+        std::memcpy(line + prefix.size(), text.data(), text.size());
+        line[length - 1] = '\n';
+        queue->push(std::string_view(line, length));
+    } else {
+        std::string joined;
+        joined.reserve(length);
+        joined.append(prefix).append(text).push_back('\n');
+        queue->push(joined);
+    }
+}
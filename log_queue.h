@@ -0,0 +1,168 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * A log queue shared by many threads (similar to a Channel<string> in C#
+ * with one reader, or to posting messages to a single logging worker in
+ * Node.js).
+ *
+ * Producers push preformatted records (usually whole lines) into a bounded
+ * ring of 64-byte slots without taking a lock: a record claims one or more
+ * consecutive slots with a single compare-and-swap. One drainer thread
+ * copies the records out in order, batches them and writes them to the
+ * destination stream, so the destination is only ever touched by one
+ * thread and nobody waits on its lock.
+ *
+ * When the ring is full the BackPressure policy decides:
+ *   - Block: the producer waits (yielding) until the drainer makes room
+ *   - Drop:  the record is thrown away and counted in dropped()
+ *   - Spill: the record goes to a buffer private to the producing thread
+ *            (at most kSpillLimit bytes, after that it blocks), which the
+ *            drainer picks up as soon as the ring is empty again
+ *
+ * Records from one thread always come out in the order they were pushed,
+ * spilled or not. Records from different threads are interleaved, but a
+ * record is never split.
+ */
+enum class BackPressure {
+    Block,
+    Drop,
+    Spill,
+};
+
+// "block", "drop" or "spill"; throws std::invalid_argument for anything else
+BackPressure parseBackPressure(std::string_view name);
+const char* backPressureName(BackPressure policy);
+
+class LogQueue {
+  public:
+      static constexpr std::size_t kSlotSize = 64;              // One cache line
+      static constexpr std::size_t kDefaultCapacity = 4096;     // Slots (256 KiB)
+      static constexpr std::size_t kMaxRecord = 4096;           // Longer records are truncated
+      static constexpr std::size_t kSpillLimit = 1024 * 1024;   // Bytes per producing thread
+
+      // The capacity is rounded up to a power of two, at least 128 slots
+      explicit LogQueue(std::ostream& destination,
+                        BackPressure policy = BackPressure::Block,
+                        std::size_t capacity = kDefaultCapacity);
+      // Writes everything still queued, then stops the drainer. Nothing
+      // may be pushed once destruction has started.
+      ~LogQueue();
+
+      LogQueue(const LogQueue&) = delete;
+      LogQueue& operator=(const LogQueue&) = delete;
+
+      // Queues one record; safe to call from any number of threads.
+      // Returns false if the record was dropped.
+      bool push(std::string_view record);
+
+      // Returns once every record pushed before the call (by this thread,
+      // or by threads that have finished pushing) has been written and the
+      // destination flushed
+      void flush();
+
+      BackPressure policy() const { return policy_; }
+      std::size_t capacity() const { return mask_ + 1; }
+      std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+      std::uint64_t spilled() const { return spilledTotal_.load(std::memory_order_relaxed); }
+
+  private:
+      struct Slot {
+          std::atomic<std::uint64_t> sequence;   // Position it is free for, or position + 1 once filled
+          char data[kSlotSize - sizeof(std::atomic<std::uint64_t>)];
+      };
+
+      struct SpillBuffer {
+          std::mutex mutex;                      // Between its owner and the drainer
+          std::deque<std::string> records;
+          std::size_t bytes = 0;
+          std::atomic<bool> pending{false};      // records is not empty
+      };
+
+      static constexpr std::size_t kPayload = sizeof(Slot::data);
+      static constexpr std::size_t kHeader = sizeof(std::uint32_t);   // Record length, in the first slot
+
+      Slot& slot(std::uint64_t position) { return slots_[position & mask_]; }
+      static std::size_t slotsFor(std::size_t length);
+
+      bool tryPush(std::string_view record);
+      bool pushSpilling(std::string_view record);
+      // The calling thread's spill buffer for this queue (nullptr if it never spilled)
+      SpillBuffer* findSpillBuffer();
+      SpillBuffer& createSpillBuffer();
+      // (queue id, buffer) for every queue the calling thread has spilled into
+      static std::vector<std::pair<std::uint64_t, SpillBuffer*>>& threadSpills();
+      void wakeDrainer(bool always);
+
+      // Drainer side
+      void drainLoop();
+      bool popInto(std::string& batch);
+      std::size_t takeSpills(std::string& batch);
+      bool idle();
+
+      std::ostream& destination_;
+      BackPressure policy_;
+      std::uint64_t id_;                          // Tells queues apart in the per-thread spill cache
+      std::size_t mask_;
+      std::unique_ptr<Slot[]> slots_;
+
+      alignas(64) std::atomic<std::uint64_t> tail_{0};     // Next position to claim (producers)
+      alignas(64) std::atomic<std::uint64_t> head_{0};     // Next position to read (drainer)
+      std::atomic<std::uint64_t> flushedThrough_{0};       // Everything before it is written and flushed
+      std::atomic<std::uint64_t> flushCount_{0};           // Destination flushes done on request
+      std::atomic<bool> flushWanted_{false};
+      std::atomic<bool> stopping_{false};
+      std::atomic<bool> sleeping_{false};
+      std::atomic<std::uint32_t> signal_{0};                // The drainer sleeps on this
+
+      std::atomic<std::uint64_t> dropped_{0};
+      std::atomic<std::uint64_t> spilledTotal_{0};
+      std::atomic<std::uint64_t> spillRecords_{0};         // Spilled but not written yet
+
+      std::mutex spillsMutex_;
+      std::vector<std::unique_ptr<SpillBuffer>> spills_;
+
+      std::thread drainer_;
+};
+
+// Makes `queue` the destination of QueuedLogging while in scope (RAII).
+// Unlike ScopedOutput this is process-wide: every thread logs into it.
+class ScopedLogQueue {
+  public:
+      explicit ScopedLogQueue(LogQueue& queue);
+      ~ScopedLogQueue();
+
+      ScopedLogQueue(const ScopedLogQueue&) = delete;
+      ScopedLogQueue& operator=(const ScopedLogQueue&) = delete;
+
+  private:
+      LogQueue* previous_;
+};
+
+// The queue installed by ScopedLogQueue, or nullptr
+LogQueue* currentLogQueue();
+
+// Pushes prefix + text + '\n' as one record to the current queue, or
+// writes it to output() when there is none
+void queueLogLine(std::string_view prefix, std::string_view text);
+
+// A Person/Employee logging policy (see person.h) for objects created and
+// destroyed on many threads at once: the lines go through the current
+// LogQueue instead of each thread writing to a stream itself
+struct QueuedLogging {
+    static void personCreated(const std::string& name) { queueLogLine("Person created: ", name); }
+    static void personDestroyed(const std::string& name) { queueLogLine("Person destroyed: ", name); }
+    static void employeeCreated(std::string_view company) { queueLogLine("Employee created at ", company); }
+};
@@ -6,14 +6,42 @@
 #include <algorithm>    // For STL algorithms
 #include <functional>   // For function objects, lambdas
 #include <sstream>      // For string streams
+#include <fstream>      // For file streams
 #include <iomanip>      // For io manipulators
 #include <string_view>  // For efficient string views (C++17)
+#include <charconv>     // For std::from_chars (fast, locale-independent parsing)
+#include <cstdio>       // For snprintf
+#include <stdexcept>    // For standard exception types
+#include <optional>     // Similar to C# nullable types (Nullable<T>)
 
 // Include these when using C++20 features
-#if __cplusplus >= 202002L
+// (not every C++20 standard library ships <format> yet, e.g. GCC 12)
+#if __has_include(<format>)
 #include <format>       // For std::format (C++20)
 #endif
 
+#include "age_stats.h"
+#include "bulk_input.h"
+#include "checked.h"
+#include "compile_time.h"
+#include "fast_parse.h"
+#include "instrumentation.h"
+#include "flat_map.h"
+#include "format_buffer.h"
+#include "mapped_file.h"
+#include "number_report.h"
+#include "options.h"
+#include "output_sink.h"
+#include "parallel_parse.h"
+#include "person.h"
+#include "person_dispatch.h"
+#include "person_pool.h"
+#include "person_table.h"
+#include "pipeline.h"
+#include "section_registry.h"
+#include "stl_bulk.h"
+#include "thread_pool.h"
+
 /*
  * Welcome to C++ from C# and JavaScript!
  * 
@@ -27,267 +55,246 @@ void demonstrateModernIO(); // New section for modern I/O
 void demonstrateVariablesAndTypes();
 void demonstrateControlFlow();
 void demonstrateFunctions(int value);
-int returnSum(int a, int b);
 void demonstrateReferencesAndPointers();
 void demonstrateClasses();
 void demonstrateModernCpp();
-void demonstrateStl();
+void demonstrateStl(const StlOptions& options = {});
 void demonstrateErrorHandling();
 
 // Entry point of the program
-int main() {
-    std::cout << "==============================" << std::endl;
-    std::cout << "C++ Tutorial for C# and JS Developers" << std::endl;
-    std::cout << "==============================" << std::endl;
-    
-    demonstrateBasicSyntax();
-    demonstrateVariablesAndTypes();
-    demonstrateControlFlow();
-    demonstrateFunctions(42);
-    std::cout << "Sum: " << returnSum(5, 7) << std::endl;
-    demonstrateReferencesAndPointers();
-    demonstrateClasses();
-    demonstrateModernCpp();
-    demonstrateStl();
-    demonstrateErrorHandling();
-    demonstrateModernIO(); // Added this call
-    
-    std::cout << "\nTutorial completed successfully!" << std::endl;
-    return 0;
-}
-
-// ----- Basic Syntax -----
-void demonstrateBasicSyntax() {
-    std::cout << "\n----- Basic Syntax -----\n";
-    
-    // Comments are the same as in C# and JavaScript
-    // Single line comment
+int main(int argc, char* argv[]) {
+    // The sections in the order they are printed. Each one is independent,
+    // so they can run on separate threads (see section_registry.h).
+    // Filled in below, before any section runs
+    Options options;
+    
+    SectionRegistry registry;
+    // Sections without real I/O can print their compile-time rendering
+    // instead (--precomputed, see compile_time.h)
+    auto precomputedOr = [&options](std::string_view text, std::function<void()> live) {
+        return [&options, text, live = std::move(live)] {
+            if (options.precomputed) {
+                output() << text;
+            } else {
+                live();
+            }
+        };
+    };
+    registry.add("basic-syntax", precomputedOr(compile_time::basicSyntaxText, demonstrateBasicSyntax));
+    registry.add("variables-and-types", precomputedOr(compile_time::variablesAndTypesText, demonstrateVariablesAndTypes));
+    registry.add("control-flow", precomputedOr(compile_time::controlFlowText, demonstrateControlFlow));
+    registry.add("functions", precomputedOr(compile_time::functionsText, [] { demonstrateFunctions(42); }));
+    registry.add("references-and-pointers", demonstrateReferencesAndPointers);
+    registry.add("classes", demonstrateClasses);
+    registry.add("modern-cpp", demonstrateModernCpp);
+    registry.add("stl", [&options] { demonstrateStl(options.stl); });
+    registry.add("error-handling", demonstrateErrorHandling);
+    registry.add("modern-io", demonstrateModernIO); // Added this call
     
-    /*
-     * Multi-line comment
-     */
+    try {
+        options = parseOptions(argc, argv);
+        registry.select(options.only);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        printUsage(std::cerr, argv[0]);
+        return 1;
+    }
+    if (options.showHelp) {
+        printUsage(std::cout, argv[0]);
+        return 0;
+    }
+    if (options.listSections) {
+        for (const Section& section : registry.sections()) {
+            std::cout << section.name << '\n';
+        }
+        return 0;
+    }
     
-    // Statements end with semicolons (like C# and unlike JavaScript where they're optional)
-    std::cout << "Hello, World!" << std::endl;
+    // For a process that is started, prints one section and exits
+    // (--fast-startup): nothing here reads std::cin, so it need not flush
+    // std::cout before every read, and the sink below skips std::cout
+    // altogether. The iostreams are still initialized when the program
+    // loads; that, and loading the shared C++ runtime, is most of what is
+    // left (see MYPROJECT_STATIC_RUNTIME in CMakeLists.txt).
+    if (options.fastStartup) {
+        std::cin.tie(nullptr);
+    }
+    // Must come before the first output: std::cout gets its own buffer
+    // instead of going through C stdio for every write
+    if (!options.syncStdio) {
+        std::ios::sync_with_stdio(false);
+    }
     
-    // std::cout is for console output (similar to Console.WriteLine in C# or console.log in JS)
-    // << is the stream insertion operator
-    // std::endl inserts a newline and flushes the buffer (similar to \n but with flush)
-}
-
-// ----- Variables and Types -----
-void demonstrateVariablesAndTypes() {
-    std::cout << "\n----- Variables and Types -----\n";
-    
-    // C++ is statically typed
-    // Basic types
-    int integerValue = 42;                 // 32-bit integer
-    double floatingPoint = 3.14159;        // Double precision floating point
-    char singleCharacter = 'A';            // Single character
-    bool booleanValue = true;              // Boolean (true/false)
-    
-    // In C++, strings are objects, not primitive types like in C#
-    std::string text = "Hello, C++";       // String class 
-    
-    // C++ has const for constants (similar to const in C# and JavaScript)
-    const int unchangeable = 100;
-    
-    // C++ handles Unicode differently than C# and JavaScript
-    // Unicode strings often use wstring, u16string, or u32string
-    std::wstring wideText = L"Wide character string";
-    
-    // Print variables
-    std::cout << "Integer: " << integerValue << std::endl;
-    std::cout << "Double: " << floatingPoint << std::endl;
-    std::cout << "Char: " << singleCharacter << std::endl;
-    std::cout << "Boolean: " << std::boolalpha << booleanValue << std::endl;
-    std::cout << "String: " << text << std::endl;
-    
-    // Type conversion (more explicit than JavaScript, similar to C#)
-    int x = 5;
-    double y = static_cast<double>(x) / 2;  // 2.5 (not 2 because of explicit conversion)
-    std::cout << "5/2 with conversion: " << y << std::endl;
-    
-    // Without conversion, integer division would truncate:
-    std::cout << "5/2 without conversion: " << 5/2 << std::endl;
-}
-
-// ----- Control Flow -----
-void demonstrateControlFlow() {
-    std::cout << "\n----- Control Flow -----\n";
-    
-    // If statements (similar to C# and JavaScript)
-    int x = 10;
-    if (x > 5) {
-        std::cout << "x is greater than 5" << std::endl;
-    } else if (x == 5) {
-        std::cout << "x is equal to 5" << std::endl;
-    } else {
-        std::cout << "x is less than 5" << std::endl;
+    // Every section writes into one shared, buffered sink instead of
+    // flushing std::cout on every line. It is flushed once per section
+    // and one last time when it goes out of scope at exit.
+    OutputSink sink = options.fastStartup && OutputSink::kFileDescriptorSupported
+                          ? OutputSink(1 /* stdout */, options.bufferSize, options.unbuffered)
+                          : OutputSink(std::cout, options.bufferSize, options.unbuffered);
+    std::ostream& out = sink.stream();
+    
+    // Bulk input mode: the validation loop from demonstrateModernIO, but
+    // over a whole file or pipe instead of one std::cin extraction at a time
+    if (!options.inputPath.empty()) {
+        try {
+            BlockReader reader(options.inputPath);
+            ValidationReport report;
+            if (options.jobs > 1) {
+                ThreadPool pool(options.jobs);
+                report = validatePositiveIntegersParallel(pool, reader);
+            } else {
+                report = validatePositiveIntegers(reader);
+            }
+            printReport(out, options.inputPath == "-" ? "stdin" : options.inputPath, report);
+        } catch (const std::runtime_error& e) {
+            sink.flush();
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
     }
     
-    // Switch statements (similar to C# and JavaScript)
-    switch (x) {
-        case 5:
-            std::cout << "x is 5" << std::endl;
-            break;
-        case 10:
-            std::cout << "x is 10" << std::endl;
-            break;
-        default:
-            std::cout << "x is neither 5 nor 10" << std::endl;
-            break;
+    // Memory-mapped parse mode: the string-stream parsing demo from
+    // demonstrateModernIO run over a whole file, with no copy of the file
+    if (!options.mmapPath.empty()) {
+        try {
+            std::optional<ThreadPool> pool;
+            if (options.jobs > 1) {
+                pool.emplace(options.jobs);
+            }
+            FileParseResult result = parseFile(options.mmapPath, pool ? &*pool : nullptr);
+            printParseSummary(out, options.mmapPath, result.summary);
+            out << "   Bytes: " << result.bytes
+                << (result.mapped ? " (memory mapped)" : " (buffered reads)") << '\n';
+        } catch (const std::runtime_error& e) {
+            sink.flush();
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
     }
     
-    // For loop (similar to C# and JavaScript)
-    std::cout << "For loop: ";
-    for (int i = 0; i < 5; i++) {
-        std::cout << i << " ";
+    // Asynchronous report mode: a report far larger than the output buffer,
+    // written straight to stdout by an event loop while the next chunk is
+    // being formatted (see async_writer.h and number_report.h)
+    if (options.numberRows > 0) {
+        sink.flush();
+        try {
+            async_io::EventLoop loop(1 /* stdout */, options.ioBackend);
+            loop.spawn(writeNumberReport(loop, options.numberRows));
+            loop.run();
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
     }
-    std::cout << std::endl;
     
-    // Range-based for loop (similar to foreach in C# or for...of in JavaScript)
-    std::vector<int> numbers = {1, 2, 3, 4, 5};
-    std::cout << "Range-based for loop: ";
-    for (int num : numbers) {
-        std::cout << num << " ";
+    out << "==============================" << '\n';
+    out << "C++ Tutorial for C# and JS Developers" << '\n';
+    out << "==============================" << '\n';
+    
+    instrumentation::nameThread("main");
+    if (!options.tracePath.empty()) {
+        instrumentation::StatsCollector::global().enableTracing();
     }
-    std::cout << std::endl;
-    
-    // While loop (similar to C# and JavaScript)
-    std::cout << "While loop: ";
-    int i = 0;
-    while (i < 5) {
-        std::cout << i << " ";
-        i++;
+    if (options.perfMarkers && !instrumentation::StatsCollector::global().enableMarkers()) {
+        std::cerr << "Warning: cannot open the ftrace trace_marker file, --perf-markers ignored\n";
     }
-    std::cout << std::endl;
-    
-    // Do-while loop (similar to C# and JavaScript)
-    std::cout << "Do-while loop: ";
-    i = 0;
-    do {
-        std::cout << i << " ";
-        i++;
-    } while (i < 5);
-    std::cout << std::endl;
-}
-
-// ----- Functions -----
-// Function with a parameter (similar to C# and JavaScript)
-void demonstrateFunctions(int value) {
-    std::cout << "\n----- Functions -----\n";
-    std::cout << "Function parameter: " << value << std::endl;
     
-    // Local variable scope (similar to C# and JavaScript)
-    {
-        int localVar = 100;
-        std::cout << "Inside local scope: " << localVar << std::endl;
-    }
-    // localVar is not accessible here
+    SectionRunner runner(sink, options.jobs);
+    runner.run(registry.sections());
     
-    // Default parameters (similar to C# and JavaScript)
-    auto defaultParamFunction = [](int a = 1, int b = 2) {
-        return a + b;
-    };
+    out << "\nTutorial completed successfully!" << '\n';
     
-    std::cout << "Default params (no args): " << defaultParamFunction() << std::endl;
-    std::cout << "Default params (one arg): " << defaultParamFunction(10) << std::endl;
-    std::cout << "Default params (two args): " << defaultParamFunction(10, 20) << std::endl;
+    // Statistics go to stderr or a file, so stdout stays the tutorial text
+    if (options.stats) {
+        sink.flush();
+        instrumentation::StatsCollector::global().printSummary(std::cerr);
+    }
+    if (!options.statsJsonPath.empty()) {
+        std::ofstream json(options.statsJsonPath);
+        instrumentation::StatsCollector::global().writeJson(json);
+        if (!json) {
+            std::cerr << "Error: cannot write " << options.statsJsonPath << "\n";
+            return 1;
+        }
+    }
+    if (!options.tracePath.empty()) {
+        std::ofstream trace(options.tracePath);
+        instrumentation::StatsCollector::global().writeChromeTrace(trace);
+        if (!trace) {
+            std::cerr << "Error: cannot write " << options.tracePath << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// ----- Basic Syntax, Variables and Types, Control Flow, Functions -----
+// These four sections are in compile_time.h, written once over the output
+// type: here they go to the buffered sink, and the compiler renders the
+// same code into the texts that --precomputed prints
+void demonstrateBasicSyntax() {
+    compile_time::BasicSyntaxSection::write(output());
+}
+
+void demonstrateVariablesAndTypes() {
+    compile_time::VariablesAndTypesSection::write(output());
 }
 
-// Function with return value (similar to C# and JavaScript)
-int returnSum(int a, int b) {
-    return a + b;
+void demonstrateControlFlow() {
+    compile_time::ControlFlowSection::write(output());
+}
+
+// Function with a parameter (similar to C# and JavaScript)
+void demonstrateFunctions(int value) {
+    compile_time::FunctionsSection::write(output(), value);
 }
 
 // ----- References and Pointers -----
 void demonstrateReferencesAndPointers() {
-    std::cout << "\n----- References and Pointers -----\n";
+    std::ostream& out = output();
+    out << "\n----- References and Pointers -----\n";
     
     // References (similar to ref parameters in C#)
     int original = 42;
     int& reference = original;  // Reference to original
     
-    std::cout << "Original: " << original << std::endl;
-    std::cout << "Reference: " << reference << std::endl;
+    out << "Original: " << original << '\n';
+    out << "Reference: " << reference << '\n';
     
     // Modifying through reference affects original
     reference = 100;
-    std::cout << "After modifying reference, original: " << original << std::endl;
+    out << "After modifying reference, original: " << original << '\n';
     
     // Pointers (no direct equivalent in C# or JavaScript)
     int value = 42;
     int* pointer = &value;  // Pointer to value
     
-    std::cout << "Value: " << value << std::endl;
-    std::cout << "Pointer address: " << pointer << std::endl;
-    std::cout << "Dereferenced pointer: " << *pointer << std::endl;
+    out << "Value: " << value << '\n';
+    out << "Pointer address: " << pointer << '\n';
+    out << "Dereferenced pointer: " << *pointer << '\n';
     
     // Modifying through pointer affects original
     *pointer = 200;
-    std::cout << "After modifying pointer, value: " << value << std::endl;
+    out << "After modifying pointer, value: " << value << '\n';
     
     // Smart pointers (Modern C++, somewhat similar to C# reference types)
     std::unique_ptr<int> smartPtr = std::make_unique<int>(42);
-    std::cout << "Smart pointer value: " << *smartPtr << std::endl;
+    out << "Smart pointer value: " << *smartPtr << '\n';
     
     // std::unique_ptr automatically deallocates memory when it goes out of scope
     // No need for manual memory management!
 }
 
 // ----- Classes and OOP -----
-// Class definition (similar to C# classes, different from JavaScript classes)
-class Person {
-  private:
-      std::string name;
-      int age;
-      
-  public:
-      // Constructor
-      Person(const std::string& n, int a) : name(n), age(a) {
-          std::cout << "Person created: " << name << std::endl;
-      }
-      
-      // Destructor (called automatically when object is destroyed)
-      // No equivalent in C# (handled by garbage collection) or JavaScript
-      ~Person() {
-          std::cout << "Person destroyed: " << name << std::endl;
-      }
-      
-      // Member functions (methods)
-      void introduce() const {
-          std::cout << "Hi, I'm " << name << " and I'm " << age << " years old." << std::endl;
-      }
-      
-      // Getters and setters (similar to C# properties)
-      std::string getName() const { return name; }
-      void setName(const std::string& n) { name = n; }
-      
-      int getAge() const { return age; }
-      void setAge(int a) { age = a; }
-};
-
-// Inheritance example
-class Employee : public Person {
-  private:
-      std::string company;
-      
-  public:
-      Employee(const std::string& n, int a, const std::string& c) 
-          : Person(n, a), company(c) {
-          std::cout << "Employee created at " << company << std::endl;
-      }
-      
-      // Override method
-      void introduce() const {
-          std::cout << "Hi, I'm " << getName() << ", " << getAge() 
-                    << " years old, and I work at " << company << "." << std::endl;
-      }
-};
+// Person and Employee are defined in person.h, so the benchmarks and the
+// bulk containers (person_pool.h) can use them too
 
 void demonstrateClasses() {
-    std::cout << "\n----- Classes and OOP -----\n";
+    std::ostream& out = output();
+    out << "\n----- Classes and OOP -----\n";
     
     // Create objects on the stack (automatically destroyed when out of scope)
     Person alice("Alice", 30);
@@ -306,47 +313,87 @@ void demonstrateClasses() {
     // Inheritance
     Employee dave("Dave", 40, "Acme Inc");
     dave.introduce();  // Calls the overridden method
+    
+    // Careful: introduce() is not virtual, so the *static* type decides
+    // which one runs. Through a Person& we get Person's version.
+    const Person& daveAsPerson = dave;
+    daveAsPerson.introduce();
+    
+    // A std::variant knows what it holds, and std::visit calls the right
+    // introduce() without any virtual functions (see person_dispatch.h)
+    std::vector<AnyPerson<NoLogging>> mixed;
+    mixed.emplace_back(std::in_place_type<BasicPerson<NoLogging>>, "Heidi", 29);
+    mixed.emplace_back(std::in_place_type<BasicEmployee<NoLogging>>, "Ivan", 52, "Acme Inc");
+    for (const auto& person : mixed) {
+        introduce(person);
+    }
+    
+    // Many objects at once: an arena constructs them side by side in big
+    // chunks and frees them all together (see person_pool.h). NoLogging
+    // turns off the "Person created/destroyed" lines for the whole pool.
+    PersonPool<NoLogging> pool;
+    for (int i = 0; i < 1000; i++) {
+        pool.addPerson("Pooled", 20 + i % 50);
+    }
+    long long totalAge = 0;
+    pool.forEachPerson([&totalAge](const auto& person) { totalAge += person.getAge(); });
+    out << "Pool of " << pool.personCount() << " people, average age "
+        << totalAge / static_cast<long long>(pool.personCount()) << '\n';
+    pool.release();    // Everyone at once
+    
+    // The same data stored column by column (see person_table.h): all ages
+    // next to each other, names and companies as ids into a string pool
+    PersonTable table;
+    table.addPerson("Erin", 28);
+    table.addEmployee("Frank", 45, "Acme Inc");
+    table.addEmployee("Grace", 33, "Acme Inc");
+    table[1].introduce();
+    out << "Table of " << table.size() << " rows, average age " << table.averageAge()
+        << ", " << table.countAtCompany("Acme Inc") << " at Acme Inc" << '\n';
 }
 
 // ----- Modern C++ Features -----
 void demonstrateModernCpp() {
-    std::cout << "\n----- Modern C++ Features -----\n";
+    std::ostream& out = output();
+    out << "\n----- Modern C++ Features -----\n";
     
     // Auto type deduction (similar to var in C# and JavaScript)
     auto value = 42;      // int
     auto text = "hello";  // const char*
     auto pi = 3.14159;    // double
     
-    std::cout << "Auto variables: " << value << ", " << text << ", " << pi << std::endl;
+    out << "Auto variables: " << value << ", " << text << ", " << pi << '\n';
     
     // Lambda expressions (similar to lambdas in C# and arrow functions in JavaScript)
-    auto add = [](int a, int b) { return a + b; };
-    std::cout << "Lambda result: " << add(3, 4) << std::endl;
+    // compile_time::add is the lambda [](int a, int b) { return a + b; },
+    // declared constexpr so the call below is evaluated by the compiler
+    constexpr int sum = compile_time::add(3, 4);
+    out << "Lambda result: " << sum << '\n';
     
-    // Lambda with capture
-    int multiplier = 10;
-    auto multiply = [multiplier](int x) { return x * multiplier; };
-    std::cout << "Lambda with capture: " << multiply(5) << std::endl;
+    // Lambda with capture: makeMultiplier returns [multiplier](int x) { return x * multiplier; }
+    constexpr auto multiply = compile_time::makeMultiplier(10);
+    out << "Lambda with capture: " << multiply(5) << '\n';
     
     // Move semantics (no direct equivalent in C# or JavaScript)
     std::string source = "Original string";
     std::string destination = std::move(source); // Efficiently transfers ownership
     
-    std::cout << "After move, destination: " << destination << std::endl;
-    std::cout << "After move, source: " << source << std::endl; // source may be empty
+    out << "After move, destination: " << destination << '\n';
+    out << "After move, source: " << source << '\n'; // source may be empty
     
     // Initializer lists (similar to collection initializers in C#)
     std::vector<int> numbers = {1, 2, 3, 4, 5};
-    std::cout << "Initializer list: ";
+    out << "Initializer list: ";
     for (int n : numbers) {
-        std::cout << n << " ";
+        out << n << " ";
     }
-    std::cout << std::endl;
+    out << '\n';
 }
 
 // ----- Standard Template Library (STL) -----
-void demonstrateStl() {
-    std::cout << "\n----- Standard Template Library -----\n";
+void demonstrateStl(const StlOptions& options) {
+    std::ostream& out = output();
+    out << "\n----- Standard Template Library -----\n";
     
     // Vectors (similar to List<T> in C# or arrays in JavaScript)
     std::vector<int> numbers = {10, 20, 30, 40, 50};
@@ -354,11 +401,11 @@ void demonstrateStl() {
     numbers.push_back(60);  // Add element to end
     numbers.pop_back();     // Remove last element
     
-    std::cout << "Vector elements: ";
+    out << "Vector elements: ";
     for (int num : numbers) {
-        std::cout << num << " ";
+        out << num << " ";
     }
-    std::cout << std::endl;
+    out << '\n';
     
     // Maps (similar to Dictionary<K,V> in C# or objects in JavaScript)
     std::map<std::string, int> ages;
@@ -366,47 +413,101 @@ void demonstrateStl() {
     ages["Bob"] = 25;
     ages["Charlie"] = 35;
     
-    std::cout << "Map elements:" << std::endl;
+    out << "Map elements:" << '\n';
     for (const auto& pair : ages) {
-        std::cout << pair.first << ": " << pair.second << std::endl;
+        out << pair.first << ": " << pair.second << '\n';
     }
     
+    // The same table in the containers from flat_map.h, which share one
+    // interface (so this lambda works with any of them) and look keys up
+    // as string_views instead of building a std::string for every lookup
+    auto fillAndPrint = [&out](const char* title, auto& table) {
+        table["Alice"] = 30;
+        table["Bob"] = 25;
+        table["Charlie"] = 35;
+        out << title << ": ";
+        table.forEachOrdered([&out](std::string_view name, int age) {
+            out << name << " = " << age << " ";
+        });
+        out << '\n';
+    };
+    FlatHashMap<int> flatAges;
+    SortedVectorMap<int> sortedAges;
+    fillAndPrint("Flat hash map", flatAges);
+    fillAndPrint("Sorted vector map", sortedAges);
+    std::string_view who = "Bob";
+    if (const int* age = flatAges.find(who)) {
+        out << "Lookup " << who << " (no temporary string): " << *age << '\n';
+    }
+
+    // A map that keeps its statistics up to date on every change
+    // (age_stats.h), so asking for them never scans the table
+    AgeStatsMap<int> trackedAges;
+    trackedAges.insert("Alice", 30);
+    trackedAges.insert("Bob", 25);
+    trackedAges.insert("Charlie", 35);
+    trackedAges.setAge("Bob", 26);
+    trackedAges.erase("Charlie");
+    const AgeStats& stats = trackedAges.stats();
+    out << "Tracked ages: count " << stats.count() << ", sum " << stats.sum() << ", youngest " << stats.min()
+        << ", oldest " << stats.max() << ", in their twenties " << stats.histogram().at(20) << '\n';
+    
     // STL algorithms (some similarity to LINQ in C# or array methods in JavaScript)
-    std::cout << "Find 30 in vector: ";
+    out << "Find 30 in vector: ";
     auto it = std::find(numbers.begin(), numbers.end(), 30);
     if (it != numbers.end()) {
-        std::cout << "Found at position " << (it - numbers.begin()) << std::endl;
+        out << "Found at position " << (it - numbers.begin()) << '\n';
     } else {
-        std::cout << "Not found" << std::endl;
+        out << "Not found" << '\n';
     }
     
     // Sort elements
     std::sort(numbers.begin(), numbers.end());
-    std::cout << "Sorted vector: ";
+    out << "Sorted vector: ";
     for (int num : numbers) {
-        std::cout << num << " ";
+        out << num << " ";
     }
-    std::cout << std::endl;
+    out << '\n';
     
     // Transform elements (similar to .map() in JavaScript or .Select() in C# LINQ)
     std::vector<int> doubled(numbers.size());
     std::transform(numbers.begin(), numbers.end(), doubled.begin(),
                   [](int x) { return x * 2; });
     
-    std::cout << "Doubled vector: ";
+    out << "Doubled vector: ";
     for (int num : doubled) {
-        std::cout << num << " ";
+        out << num << " ";
+    }
+    out << '\n';
+    
+    // The same doubling as a lazy pipeline (pipeline.h, similar to chaining
+    // LINQ's Select/Where/Sum): transform, filter and sum run in one pass,
+    // with no `doubled` vector and no loop per stage
+    int bigDoubledSum = numbers
+                      | pipeline::transform([](int x) { return x * 2; })
+                      | pipeline::filter([](int x) { return x > 40; })
+                      | pipeline::sum();
+    out << "Sum of doubled values over 40: " << bigDoubledSum << '\n';
+    
+    // The same three algorithms over a large array (--stl-size N), against
+    // the SIMD kernels in kernels.h
+    if (options.bulkSize > 0) {
+        try {
+            runBulkStl(out, options);
+        } catch (const std::exception& e) {
+            out << "Bulk algorithms failed: " << e.what() << '\n';
+        }
     }
-    std::cout << std::endl;
 }
 
 // ----- Error Handling -----
 void demonstrateErrorHandling() {
-    std::cout << "\n----- Error Handling -----\n";
+    std::ostream& out = output();
+    out << "\n----- Error Handling -----\n";
     
     // Try-catch blocks (similar to C# and JavaScript)
     try {
-        std::cout << "Attempting division..." << std::endl;
+        out << "Attempting division..." << '\n';
         
         int numerator = 10;
         int denominator = 2;  // Try changing this to 0
@@ -417,86 +518,123 @@ void demonstrateErrorHandling() {
         }
         
         int result = numerator / denominator;
-        std::cout << "Result: " << result << std::endl;
+        out << "Result: " << result << '\n';
         
         // Using array with bounds checking
         std::vector<int> vec = {1, 2, 3};
         // This will throw std::out_of_range if i is out of bounds:
-        std::cout << "vec[1]: " << vec.at(1) << std::endl; 
+        out << "vec[1]: " << vec.at(1) << '\n'; 
         
     } catch (const std::runtime_error& e) {
         // Catch specific exception type
-        std::cout << "Runtime error: " << e.what() << std::endl;
+        out << "Runtime error: " << e.what() << '\n';
     } catch (const std::out_of_range& e) {
         // Catch out of range exceptions
-        std::cout << "Out of range error: " << e.what() << std::endl;
+        out << "Out of range error: " << e.what() << '\n';
     } catch (const std::exception& e) {
         // Catch all standard exceptions
-        std::cout << "Standard exception: " << e.what() << std::endl;
+        out << "Standard exception: " << e.what() << '\n';
     } catch (...) {
         // Catch all other exceptions
-        std::cout << "Unknown exception occurred" << std::endl;
+        out << "Unknown exception occurred" << '\n';
     }
+    
+    // Without exceptions (checked.h): the error is part of the return value,
+    // so a failure is a cheap branch instead of stack unwinding. Similar to
+    // int.TryParse in C#, but the result says *why* it failed.
+    for (int denominator : {2, 0}) {
+        Expected<int, ErrorCode> quotient = checkedDivide(10, denominator);
+        out << "checkedDivide(10, " << denominator << "): ";
+        if (quotient) {
+            out << *quotient << '\n';
+        } else {
+            out << errorMessage(quotient.error()) << '\n';
+        }
+    }
+    std::vector<int> values = {1, 2, 3};
+    Expected<int, ErrorCode> element = checkedAt(values, 5);
+    out << "checkedAt(values, 5): "
+        << (element ? std::to_string(*element) : errorMessage(element.error())) << '\n';
 }
 
 // ----- Modern I/O Operations -----
 void demonstrateModernIO() {
-    std::cout << "\n----- Modern I/O Operations -----\n";
+    std::ostream& out = output();
+    out << "\n----- Modern I/O Operations -----\n";
     
     // ===== OUTPUT METHODS =====
-    std::cout << "===== Modern Output Methods =====\n";
+    out << "===== Modern Output Methods =====\n";
     
     // 1. Traditional std::cout
-    std::cout << "1. Traditional std::cout with concatenation" << std::endl;
+    out << "1. Traditional std::cout with concatenation" << '\n';
     
     // 2. Using stream manipulators for formatting
     int num = 42;
     double pi = 3.14159265359;
     
-    // Format with manipulators
-    std::cout << "2. Formatted output with manipulators:" << std::endl;
-    std::cout << "   Hex: " << std::hex << std::showbase << num << std::endl;
-    std::cout << "   Decimal: " << std::dec << num << std::endl;
-    std::cout << "   Fixed precision: " << std::fixed << std::setprecision(2) << pi << std::endl;
-    std::cout << "   Scientific: " << std::scientific << pi << std::endl;
+    // Format with manipulators. Every manipulator changes the stream's
+    // state until it is reset; for whole tables of numbers,
+    // appendNumberTable (format_buffer.h) prints these same lines with
+    // std::to_chars and no stream state at all
+    out << "2. Formatted output with manipulators:" << '\n';
+    out << "   Hex: " << std::hex << std::showbase << num << '\n';
+    out << "   Decimal: " << std::dec << num << '\n';
+    out << "   Fixed precision: " << std::fixed << std::setprecision(2) << pi << '\n';
+    out << "   Scientific: " << std::scientific << pi << '\n';
     // Reset formatting
-    std::cout << std::defaultfloat << std::setprecision(6);
+    out << std::defaultfloat << std::setprecision(6);
     
     // 3. Using string streams for complex formatting
-    std::cout << "3. Using string streams:" << std::endl;
+    out << "3. Using string streams:" << '\n';
     std::ostringstream oss;
     oss << "String stream allows building complex strings: ";
     oss << "Value=" << num << ", Pi=" << std::fixed << std::setprecision(2) << pi;
-    std::cout << "   " << oss.str() << std::endl;
+    out << "   " << oss.str() << '\n';
+    
+    // The same values without a stream or a temporary string: appended
+    // with std::to_chars into a buffer that every line on this thread
+    // reuses, then written to the sink in one piece (see format_buffer.h)
+    FormatBuffer& line = threadFormatBuffer();
+    line.append("   Reusable buffer, no allocation: Value=").appendInt(num);
+    line.append(", Pi=").appendFixed(pi, 2).append('\n');
+    line.writeTo(out);
     
     // 4. printf-style formatting (still available)
-    std::cout << "4. printf-style formatting:" << std::endl;
-    printf("   Classic printf: num=%d, pi=%.2f\n", num, pi);
+    // snprintf formats into a buffer, so the text goes through the same
+    // sink as everything else instead of straight to stdout
+    out << "4. printf-style formatting:" << '\n';
+    char printfBuffer[64];
+    std::snprintf(printfBuffer, sizeof(printfBuffer), "   Classic printf: num=%d, pi=%.2f\n", num, pi);
+    out << printfBuffer;
     
     // 5. C++20 std::format (similar to C# string interpolation)
-    // Only include if C++20 is available
-#if __cplusplus >= 202002L
-    std::cout << "5. C++20 std::format (like C# string interpolation):" << std::endl;
-    std::cout << "   " << std::format("Number: {}, Pi: {:.2f}", num, pi) << std::endl;
+    // Only include if the standard library provides it
+#if defined(__cpp_lib_format)
+    out << "5. C++20 std::format (like C# string interpolation):" << '\n';
+    // std::format would return a new std::string per line: format into the
+    // reusable buffer instead (std::format_to_n under the hood)
+    FormatBuffer& formatted = threadFormatBuffer();
+    formatted.format("   Number: {}, Pi: {:.2f}\n", num, pi);
     
     // Complex formatting with std::format
-    std::cout << "   " << std::format("Hex: {0:#x}, Decimal: {0}, Pi: {1:.3f}", num, pi) << std::endl;
+    formatted.format("   Hex: {0:#x}, Decimal: {0}, Pi: {1:.3f}\n", num, pi);
+    formatted.writeTo(out);
 #else
-    std::cout << "5. C++20 std::format not available with current compiler settings" << std::endl;
+    out << "5. C++20 std::format not available with current compiler settings" << '\n';
 #endif
     
     // 6. Modern print alternative without std::endl for better performance
-    std::cout << "6. Modern printing without std::endl (better performance)\n";
+    out << "6. Modern printing without std::endl (better performance)\n";
     
     // 7. Using string_view for efficient string operations (C++17)
     std::string_view sv = "Efficient string_view for print operations";
-    std::cout << "7. Using string_view: " << sv << "\n";
+    out << "7. Using string_view: " << sv << "\n";
     
     // ===== INPUT METHODS =====
-    std::cout << "\n===== Modern Input Methods =====\n";
+    out << "\n===== Modern Input Methods =====\n";
     
     // 1. Traditional std::cin
-    std::cout << "1. Traditional std::cin (uncomment to use):" << std::endl;
+    out << "1. Traditional std::cin (uncomment to use):" << '\n';
     /*
     int input_number;
     std::cout << "   Enter a number: ";
@@ -508,7 +646,7 @@ void demonstrateModernIO() {
     */
     
     // 2. Reading entire lines with getline
-    std::cout << "2. Reading lines with std::getline (uncomment to use):" << std::endl;
+    out << "2. Reading lines with std::getline (uncomment to use):" << '\n';
     /*
     std::string input_line;
     std::cout << "   Enter a line of text: ";
@@ -517,7 +655,9 @@ void demonstrateModernIO() {
     */
     
     // 3. Input with validation
-    std::cout << "3. Input with validation (uncomment to use):" << std::endl;
+    // For large piped input, see the --input mode (bulk_input.h): it reads
+    // in blocks and validates every line without one extraction per value
+    out << "3. Input with validation (uncomment to use, or run with --input <file|->):" << '\n';
     /*
     int validated_input;
     bool valid_input = false;
@@ -536,7 +676,7 @@ void demonstrateModernIO() {
     */
     
     // 4. String streams for parsing
-    std::cout << "4. Using string streams for parsing:" << std::endl;
+    out << "4. Using string streams for parsing:" << '\n';
     std::string data = "123 3.14 Hello";
     std::istringstream iss(data);
     
@@ -546,21 +686,49 @@ void demonstrateModernIO() {
     
     iss >> parsed_int >> parsed_double >> parsed_string;
     
-    std::cout << "   Parsed int: " << parsed_int << std::endl;
-    std::cout << "   Parsed double: " << parsed_double << std::endl;
-    std::cout << "   Parsed string: " << parsed_string << std::endl;
+    out << "   Parsed int: " << parsed_int << '\n';
+    out << "   Parsed double: " << parsed_double << '\n';
+    out << "   Parsed string: " << parsed_string << '\n';
+    
+    // The same parse with <charconv> (see fast_parse.h): no stream, no locale
+    // and no allocation, and each token's type is detected rather than assumed.
+    // --mmap <file> runs it over a whole memory-mapped file (mapped_file.h).
+    Tokenizer tokenizer(data);
+    Token token;
+    out << "   With std::from_chars:";
+    while (tokenizer.next(token)) {
+        switch (token.kind) {
+            case TokenKind::Int:
+                out << " int=" << token.intValue;
+                break;
+            case TokenKind::Double:
+                out << " double=" << token.doubleValue;
+                break;
+            case TokenKind::Word:
+                out << " word=" << token.text;
+                break;
+        }
+    }
+    out << '\n';
     
     // 5. Modern approaches to parsing
-    std::cout << "5. Modern parsing approaches:" << std::endl;
+    out << "5. Modern parsing approaches:" << '\n';
     std::string number_str = "42";
     int converted = std::stoi(number_str); // String to int (also: stol, stoll, stof, stod)
-    std::cout << "   String to int: " << converted << std::endl;
+    out << "   String to int: " << converted << '\n';
+    
+    // std::from_chars reports errors through a return code instead of throwing
+    int fastConverted = 0;
+    auto [end, error] = std::from_chars(number_str.data(), number_str.data() + number_str.size(), fastConverted);
+    if (error == std::errc() && end == number_str.data() + number_str.size()) {
+        out << "   from_chars to int: " << fastConverted << '\n';
+    }
     
     // 6. Best practices for I/O in modern C++
-    std::cout << "6. Modern I/O best practices:" << std::endl;
-    std::cout << "   • Prefer '\\n' over std::endl when flushing isn't needed\n";
-    std::cout << "   • Use string_view when not modifying strings\n";
-    std::cout << "   • Use std::format in C++20 for readable formatting\n";
-    std::cout << "   • Consider using <charconv> for fast numeric conversions\n";
-    std::cout << "   • Always validate user input\n";
+    out << "6. Modern I/O best practices:" << '\n';
+    out << "   • Prefer '\\n' over std::endl when flushing isn't needed\n";
+    out << "   • Use string_view when not modifying strings\n";
+    out << "   • Use std::format in C++20 for readable formatting\n";
+    out << "   • Consider using <charconv> for fast numeric conversions\n";
+    out << "   • Always validate user input\n";
 }
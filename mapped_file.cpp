@@ -0,0 +1,86 @@
+#include "mapped_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "bulk_input.h"
+#include "parallel_parse.h"
+
+#if MYPROJECT_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#if MYPROJECT_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open '" + path + "': " + std::strerror(errno));
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        throw std::runtime_error("'" + path + "' is not a regular file");
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ > 0) {  // mmap rejects zero-length mappings
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot map '" + path + "': " + std::strerror(error));
+        }
+        // We read front to back: let the kernel read ahead aggressively
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);  // The mapping stays valid after the descriptor is closed
+#else
+    throw std::runtime_error("memory mapping is not supported on this platform");
+#endif
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+void MappedFile::unmap() {
+#if MYPROJECT_HAS_MMAP
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+FileParseResult parseFile(const std::string& path, ThreadPool* pool) {
+    FileParseResult result;
+    if constexpr (MappedFile::kSupported) {
+        MappedFile file(path);
+        result.summary = pool ? summarizeParallel(*pool, file.data()) : summarize(file.data());
+        result.mapped = true;
+        result.bytes = file.size();
+    } else {
+        BlockReader reader(path);
+        result.summary = pool ? summarizeBlocksParallel(*pool, reader) : summarizeBlocks(reader);
+        result.bytes = reader.bytesRead();
+    }
+    return result;
+}
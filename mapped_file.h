@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "fast_parse.h"
+
+class ThreadPool;
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#define MYPROJECT_HAS_MMAP 1
+#else
+#define MYPROJECT_HAS_MMAP 0
+#endif
+
+/*
+ * A read-only memory mapping of a whole file (RAII, like a C#
+ * MemoryMappedFile view). The file's pages are read straight from the page
+ * cache on first access, so parsing over data() never copies the file
+ * into a std::string or a stream buffer.
+ */
+class MappedFile {
+  public:
+      static constexpr bool kSupported = MYPROJECT_HAS_MMAP;
+
+      // Throws std::runtime_error if the file cannot be opened or mapped
+      // (or if mapping is not supported on this platform)
+      explicit MappedFile(const std::string& path);
+      ~MappedFile();
+
+      MappedFile(MappedFile&& other) noexcept;
+      MappedFile& operator=(MappedFile&& other) noexcept;
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      std::string_view data() const { return {data_, size_}; }
+      std::size_t size() const { return size_; }
+
+  private:
+      void unmap();
+
+      const char* data_ = nullptr;
+      std::size_t size_ = 0;
+};
+
+struct FileParseResult {
+    ParseSummary summary;
+    bool mapped = false;    // false when the buffered fallback was used
+    std::size_t bytes = 0;
+};
+
+// Runs the Tokenizer over a whole file: directly over a mapping where mmap
+// is available, otherwise over blocks read with BlockReader. With a pool
+// the chunks are parsed on it (see parallel_parse.h), with the same result.
+FileParseResult parseFile(const std::string& path, ThreadPool* pool = nullptr);
@@ -0,0 +1,39 @@
+#include "number_report.h"
+
+#include <algorithm>
+#include <optional>
+
+void appendNumberReport(FormatBuffer& out, std::size_t first, std::size_t last) {
+    constexpr std::size_t kBatch = 256;
+    NumberRow rows[kBatch];
+    while (first < last) {
+        std::size_t count = std::min(kBatch, last - first);
+        for (std::size_t i = 0; i < count; i++) {
+            int value = static_cast<int>(first + i);
+            rows[i] = {value, value * 3.14159265359};
+        }
+        appendNumberTable(out, std::span<const NumberRow>(rows, count));
+        first += count;
+    }
+}
+
+async_io::Task writeNumberReport(async_io::EventLoop& loop, std::size_t rows, std::size_t chunkRows) {
+    FormatBuffer buffers[2];
+    std::optional<async_io::WriteOperation> pending;
+    std::size_t turn = 0;
+    for (std::size_t first = 0; first < rows; first += chunkRows) {
+        FormatBuffer& buffer = buffers[turn];
+        turn ^= 1;
+        buffer.clear();
+        appendNumberReport(buffer, first, std::min(rows, first + chunkRows));
+        // The previous chunk went out while this one was formatted; once it
+        // is done its buffer is free for the next chunk
+        if (pending) {
+            co_await *pending;
+        }
+        pending.emplace(loop.write(buffer.view()));
+    }
+    if (pending) {
+        co_await *pending;
+    }
+}
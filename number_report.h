@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+#include "async_writer.h"
+#include "format_buffer.h"
+
+/*
+ * A large report for the asynchronous output path (--numbers N): N rows of
+ * the number table from demonstrateModernIO, written to a file descriptor
+ * chunk by chunk. Row i holds the int i and the double i * pi.
+ */
+
+inline constexpr std::size_t kNumberReportChunkRows = 16 * 1024;   // About 1.3 MB per chunk
+
+// The rows [first, last) of the report
+void appendNumberReport(FormatBuffer& out, std::size_t first, std::size_t last);
+
+// Double-buffered: chunk k is formatted while chunk k - 1 is being written
+async_io::Task writeNumberReport(async_io::EventLoop& loop, std::size_t rows,
+                                 std::size_t chunkRows = kNumberReportChunkRows);
@@ -0,0 +1,140 @@
+#include "options.h"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "instrumentation.h"
+
+namespace {
+
+std::string_view requireValue(int argc, char* argv[], int& i) {
+    std::string_view flag = argv[i];
+    if (i + 1 >= argc) {
+        throw std::invalid_argument(std::string(flag) + " requires a value");
+    }
+    return argv[++i];
+}
+
+std::size_t parseSize(std::string_view flag, std::string_view text) {
+    std::size_t value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc() || end != text.data() + text.size()) {
+        throw std::invalid_argument(std::string(flag) + ": invalid number '" + std::string(text) + "'");
+    }
+    return value;
+}
+
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    bool ioBackendGiven = false;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            options.showHelp = true;
+        } else if (arg == "--list") {
+            options.listSections = true;
+        } else if (arg == "--unbuffered") {
+            options.unbuffered = true;
+        } else if (arg == "--fast-startup") {
+            options.fastStartup = true;
+        } else if (arg == "--no-stdio-sync") {
+            options.syncStdio = false;
+        } else if (arg == "--precomputed") {
+            options.precomputed = true;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--stats-json") {
+            options.statsJsonPath = requireValue(argc, argv, i);
+        } else if (arg == "--trace") {
+            options.tracePath = requireValue(argc, argv, i);
+        } else if (arg == "--perf-markers") {
+            options.perfMarkers = true;
+        } else if (arg == "--buffer-size") {
+            options.bufferSize = parseSize(arg, requireValue(argc, argv, i));
+            if (options.bufferSize == 0) {
+                throw std::invalid_argument("--buffer-size must be greater than 0");
+            }
+            if (options.bufferSize > OutputSink::kMaxBufferSize) {
+                throw std::invalid_argument("--buffer-size must be at most "
+                                            + std::to_string(OutputSink::kMaxBufferSize));
+            }
+        } else if (arg == "--jobs" || arg == "-j") {
+            std::size_t jobs = parseSize(arg, requireValue(argc, argv, i));
+            if (jobs == 0) {
+                jobs = std::max(std::thread::hardware_concurrency(), 1u);
+            }
+            options.jobs = static_cast<unsigned>(jobs);
+        } else if (arg == "--input") {
+            options.inputPath = requireValue(argc, argv, i);
+        } else if (arg == "--mmap") {
+            options.mmapPath = requireValue(argc, argv, i);
+        } else if (arg == "--numbers") {
+            options.numberRows = parseSize(arg, requireValue(argc, argv, i));
+        } else if (arg == "--io") {
+            options.ioBackend = async_io::parseBackend(requireValue(argc, argv, i));
+            ioBackendGiven = true;
+        } else if (arg == "--stl-size") {
+            options.stl.bulkSize = parseSize(arg, requireValue(argc, argv, i));
+        } else if (arg == "--policy") {
+            options.stl.policy = parallel::parsePolicy(requireValue(argc, argv, i));
+        } else if (arg == "--only") {
+            options.only.emplace_back(requireValue(argc, argv, i));
+        } else {
+            throw std::invalid_argument("unknown option '" + std::string(arg) + "'");
+        }
+    }
+    if ((options.stats || !options.statsJsonPath.empty()) && !instrumentation::kEnabled) {
+        throw std::invalid_argument("--stats needs a build with -DMYPROJECT_INSTRUMENTATION=ON");
+    }
+    if ((!options.tracePath.empty() || options.perfMarkers) && !instrumentation::kEnabled) {
+        throw std::invalid_argument("--trace and --perf-markers need a build with -DMYPROJECT_INSTRUMENTATION=ON");
+    }
+    if (ioBackendGiven && options.numberRows == 0) {
+        throw std::invalid_argument("--io needs --numbers");
+    }
+    if (options.stl.policy != parallel::Policy::Seq && options.stl.bulkSize == 0) {
+        throw std::invalid_argument("--policy needs --stl-size");
+    }
+    return options;
+}
+
+void printUsage(std::ostream& os, const char* program) {
+    os << "Usage: " << program << " [options]\n"
+       << "  -h, --help            Show this help\n"
+       << "  --list                List the section names and exit\n"
+       << "  --only SECTION        Run only this section (repeatable)\n"
+       << "  -j, --jobs N          Run sections on N threads (0 = all cores); with\n"
+       << "                        --input or --mmap, parse the file on N threads\n"
+       << "  --input FILE          Validate one positive integer per line from FILE\n"
+       << "                        (- for stdin) instead of running the tutorial\n"
+       << "  --mmap FILE           Parse FILE like the string-stream demo, directly\n"
+       << "                        over a memory mapping of it\n"
+       << "  --numbers N           Print N rows of the number table from the I/O demo,\n"
+       << "                        formatting each chunk while the last one is written\n"
+       << "  --io BACKEND          How --numbers writes: io_uring (default, falls\n"
+       << "                        back to thread when unavailable) or thread\n"
+       << "  --stl-size N          Also run the STL algorithms over N random ints\n"
+       << "                        with the SIMD kernels, and time both\n"
+       << "  --policy POLICY       With --stl-size: also run them with the seq, par\n"
+       << "                        or par_unseq execution policy on 1 to all cores\n"
+       << "  --precomputed         Print sections without real I/O from text\n"
+       << "                        rendered at compile time\n"
+       << "  --stats               Print time and allocations per section to stderr\n"
+       << "  --stats-json FILE     Write the same statistics to FILE as JSON\n"
+       << "  --trace FILE          Write a Chrome trace (chrome://tracing, Perfetto)\n"
+       << "                        of the sections and worker thread tasks to FILE\n"
+       << "  --perf-markers        Mark section boundaries in the kernel trace\n"
+       << "                        (ftrace trace_marker, seen by perf and Perfetto)\n"
+       << "  --unbuffered          Write every line immediately (interactive use)\n"
+       << "  --fast-startup        For short runs: untie std::cin from std::cout and\n"
+       << "                        write stdout with write(2) instead of std::cout\n"
+       << "  --no-stdio-sync       Stop synchronizing the C++ streams with C stdio\n"
+       << "  --buffer-size BYTES   Output buffer size (default "
+       << OutputSink::kDefaultBufferSize << ")\n";
+}
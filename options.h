@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "async_writer.h"
+#include "output_sink.h"
+#include "parallel_stl.h"
+
+// Settings for the STL section (demonstrateStl)
+struct StlOptions {
+    std::size_t bulkSize = 0;          // --stl-size: also run the algorithms over this many ints
+    parallel::Policy policy = parallel::Policy::Seq;  // --policy: also time them in parallel
+};
+
+// Command line options (similar to the args array of Main in C#
+// or process.argv in Node.js)
+struct Options {
+    bool showHelp = false;
+    bool listSections = false;
+    bool unbuffered = false;
+    bool fastStartup = false;          // --fast-startup: untie std::cin, write stdout with write(2)
+    bool syncStdio = true;             // --no-stdio-sync: std::ios::sync_with_stdio(false)
+    bool precomputed = false;          // Print compile-time rendered text where possible
+    bool stats = false;                // --stats: per-section time and allocations on stderr
+    std::string statsJsonPath;         // --stats-json: the same as JSON, into this file
+    std::string tracePath;             // --trace: Chrome trace of sections and worker tasks
+    bool perfMarkers = false;          // --perf-markers: section boundaries in the ftrace marker file
+    std::size_t bufferSize = OutputSink::kDefaultBufferSize;
+    unsigned jobs = 1;                 // --jobs 0 means one per hardware thread
+    std::vector<std::string> only;     // Empty means every section
+    std::string inputPath;             // --input: validate this file ("-" = stdin) instead
+    std::string mmapPath;              // --mmap: parse this file in place instead
+    std::size_t numberRows = 0;        // --numbers: print a report of this many rows instead
+    async_io::Backend ioBackend = async_io::Backend::IoUring;  // --io: how --numbers writes
+    StlOptions stl;
+};
+
+// Throws std::invalid_argument for unknown flags or bad values
+Options parseOptions(int argc, char* argv[]);
+
+void printUsage(std::ostream& os, const char* program);
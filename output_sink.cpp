@@ -0,0 +1,149 @@
+#include "output_sink.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#if MYPROJECT_HAS_UNISTD
+#include <unistd.h>
+#endif
+
+namespace {
+// Each thread writes to its own current stream, so sections that run on
+// different threads never share (or interleave) output.
+thread_local std::ostream* currentOutput = nullptr;
+}
+
+OutputSink::OutputSink(std::ostream& destination, std::size_t bufferSize, bool unbuffered)
+    : destination_(&destination),
+      buffer_(unbuffered ? 0 : std::clamp<std::size_t>(bufferSize, 1, kMaxBufferSize)),
+      unbuffered_(unbuffered),
+      stream_(this) {
+    if (!unbuffered_) {
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+}
+
+OutputSink::OutputSink(int fd, std::size_t bufferSize, bool unbuffered)
+    : fd_(fd),
+      buffer_(unbuffered ? 0 : std::clamp<std::size_t>(bufferSize, 1, kMaxBufferSize)),
+      unbuffered_(unbuffered),
+      stream_(this) {
+    if constexpr (!kFileDescriptorSupported) {
+        throw std::runtime_error("OutputSink: no file descriptors on this platform");
+    }
+    if (!unbuffered_) {
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+}
+
+OutputSink::~OutputSink() {
+    flush();
+}
+
+void OutputSink::flush() {
+    writeBuffered();
+    flushDestination();
+}
+
+void OutputSink::writeBuffered() {
+    std::streamsize pending = pptr() - pbase();
+    if (pending > 0) {
+        emit(pbase(), pending);
+        setp(buffer_.data(), buffer_.data() + buffer_.size());
+    }
+}
+
+void OutputSink::forward(const char* s, std::streamsize count) {
+    emit(s, count);
+    if (std::memchr(s, '\n', static_cast<std::size_t>(count)) != nullptr) {
+        flushDestination();
+    }
+}
+
+void OutputSink::emit(const char* s, std::streamsize count) {
+    if (destination_ != nullptr) {
+        destination_->write(s, count);
+        return;
+    }
+#if MYPROJECT_HAS_UNISTD
+    // write(2) may take less than everything (a pipe, a signal): go on
+    // from where it stopped
+    auto remaining = static_cast<std::size_t>(count);
+    while (remaining > 0 && !failed_) {
+        ssize_t written = ::write(fd_, s, remaining);
+        if (written < 0 && errno != EINTR) {
+            failed_ = true;
+        } else if (written > 0) {
+            s += written;
+            remaining -= static_cast<std::size_t>(written);
+        }
+    }
+#endif
+}
+
+// A file descriptor has no buffer of its own to flush
+void OutputSink::flushDestination() {
+    if (destination_ != nullptr) {
+        destination_->flush();
+    }
+}
+
+bool OutputSink::good() const {
+    return destination_ != nullptr ? static_cast<bool>(*destination_) : !failed_;
+}
+
+OutputSink::int_type OutputSink::overflow(int_type ch) {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+        return traits_type::not_eof(ch);
+    }
+    char c = traits_type::to_char_type(ch);
+    if (unbuffered_) {
+        forward(&c, 1);
+        return ch;
+    }
+    // Buffer is full: pass it on and start over
+    writeBuffered();
+    *pptr() = c;
+    pbump(1);
+    return ch;
+}
+
+std::streamsize OutputSink::xsputn(const char* s, std::streamsize count) {
+    if (unbuffered_) {
+        forward(s, count);
+        return count;
+    }
+    std::streamsize room = epptr() - pptr();
+    if (count > room) {
+        writeBuffered();
+        // Larger than the whole buffer: copying it in first would only add work
+        if (count >= static_cast<std::streamsize>(buffer_.size())) {
+            emit(s, count);
+            return count;
+        }
+    }
+    std::memcpy(pptr(), s, static_cast<std::size_t>(count));
+    pbump(static_cast<int>(count));
+    return count;
+}
+
+// Called by std::flush / std::endl: an explicit flush request is honored
+int OutputSink::sync() {
+    flush();
+    return good() ? 0 : -1;
+}
+
+std::ostream& output() {
+    return currentOutput != nullptr ? *currentOutput : std::cout;
+}
+
+ScopedOutput::ScopedOutput(std::ostream& stream) : previous_(currentOutput) {
+    currentOutput = &stream;
+}
+
+ScopedOutput::~ScopedOutput() {
+    currentOutput = previous_;
+}
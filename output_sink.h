@@ -0,0 +1,99 @@
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#define MYPROJECT_HAS_UNISTD 1
+#else
+#define MYPROJECT_HAS_UNISTD 0
+#endif
+
+/*
+ * A buffered output sink shared by every demonstrate* section.
+ *
+ * std::endl flushes the stream on every line, which turns into one write
+ * syscall per line when the tutorial is redirected to a file or a pipe.
+ * OutputSink collects everything in a single buffer instead and hands it to
+ * the destination stream only when the buffer fills up, when flush() is
+ * called (once per section) or when the sink is destroyed (at exit).
+ *
+ * In unbuffered mode every write is forwarded immediately and the
+ * destination is flushed at each line end, which is what you want when
+ * watching the program interactively.
+ *
+ * The destination is either a std::ostream or a file descriptor. With a
+ * descriptor (--fast-startup) the buffer goes straight to write(2), like
+ * Console.OpenStandardOutput() in C# instead of Console.Out: no std::cout
+ * buffer, no locale and nothing shared with C stdio on the way.
+ */
+class OutputSink : public std::streambuf {
+  public:
+      static constexpr std::size_t kDefaultBufferSize = 64 * 1024;
+      // std::streambuf moves its write position with pbump(int); larger sizes are capped
+      static constexpr std::size_t kMaxBufferSize = INT_MAX;
+
+      // Whether this platform can write to a file descriptor (POSIX)
+      static constexpr bool kFileDescriptorSupported = MYPROJECT_HAS_UNISTD;
+
+      explicit OutputSink(std::ostream& destination,
+                          std::size_t bufferSize = kDefaultBufferSize,
+                          bool unbuffered = false);
+      // Writes to `fd` (e.g. 1 for stdout), which stays open afterwards.
+      // Throws std::runtime_error where kFileDescriptorSupported is false.
+      explicit OutputSink(int fd,
+                          std::size_t bufferSize = kDefaultBufferSize,
+                          bool unbuffered = false);
+      ~OutputSink() override;
+
+      OutputSink(const OutputSink&) = delete;
+      OutputSink& operator=(const OutputSink&) = delete;
+
+      // The stream the sections write into (like std::cout, but buffered)
+      std::ostream& stream() { return stream_; }
+
+      // Hand everything buffered so far to the destination and flush it
+      void flush();
+
+      bool unbuffered() const { return unbuffered_; }
+      std::size_t bufferSize() const { return buffer_.size(); }
+
+  protected:
+      int_type overflow(int_type ch) override;
+      std::streamsize xsputn(const char* s, std::streamsize count) override;
+      int sync() override;
+
+  private:
+      void writeBuffered();
+      void forward(const char* s, std::streamsize count);
+      void emit(const char* s, std::streamsize count);   // To the destination
+      void flushDestination();
+      bool good() const;
+
+      std::ostream* destination_ = nullptr;   // Null when writing to fd_
+      int fd_ = -1;
+      bool failed_ = false;                   // A write(2) to fd_ failed
+      std::vector<char> buffer_;
+      bool unbuffered_;
+      std::ostream stream_;
+};
+
+// The stream the current thread's section writes into.
+// Defaults to std::cout until a ScopedOutput redirects it.
+std::ostream& output();
+
+// Redirects output() for the current thread while in scope (RAII)
+class ScopedOutput {
+  public:
+      explicit ScopedOutput(std::ostream& stream);
+      ~ScopedOutput();
+
+      ScopedOutput(const ScopedOutput&) = delete;
+      ScopedOutput& operator=(const ScopedOutput&) = delete;
+
+  private:
+      std::ostream* previous_;
+};
@@ -0,0 +1,179 @@
+#include "parallel_parse.h"
+
+#include <algorithm>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Chunks in flight per pool thread: enough to keep every thread busy
+// while the oldest one is folded
+constexpr std::size_t kChunksPerThread = 3;
+
+// Runs chunk jobs on the pool and folds their results in submission order
+template <typename Result, typename Fold>
+class OrderedChunks {
+  public:
+      OrderedChunks(ThreadPool& pool, Fold fold)
+          : pool_(pool), fold_(std::move(fold)), window_(kChunksPerThread * pool.size()) {}
+
+      // After an exception: the chunks still in flight point into the input
+      ~OrderedChunks() {
+          for (PoolTask<Result>& task : pending_) {
+              try {
+                  task.get();
+              } catch (...) {
+              }
+          }
+      }
+
+      template <typename F>
+      void submit(F work) {
+          if (pending_.size() >= window_) {
+              foldOldest();
+          }
+          pending_.push_back(pool_.submit(std::move(work)));
+      }
+
+      void finish() {
+          while (!pending_.empty()) {
+              foldOldest();
+          }
+      }
+
+  private:
+      void foldOldest() {
+          Result result = pending_.front().get();
+          pending_.pop_front();
+          fold_(result);
+      }
+
+      ThreadPool& pool_;
+      Fold fold_;
+      std::size_t window_;
+      std::deque<PoolTask<Result>> pending_;
+};
+
+template <typename Result, typename Fold>
+OrderedChunks<Result, Fold> orderedChunks(ThreadPool& pool, Fold fold) {
+    return OrderedChunks<Result, Fold>(pool, std::move(fold));
+}
+
+// The totals of one chunk, plus its doubles in order for the exact sum
+struct TokenChunk {
+    ParseSummary summary;
+    std::vector<double> doubles;
+};
+
+TokenChunk parseChunk(std::string_view text) {
+    TokenChunk chunk;
+    Tokenizer tokenizer(text);
+    Token token;
+    while (tokenizer.next(token)) {
+        accumulate(chunk.summary, token);
+        if (token.kind == TokenKind::Double) {
+            chunk.doubles.push_back(token.doubleValue);
+        }
+    }
+    return chunk;
+}
+
+void foldChunk(ParseSummary& total, const TokenChunk& chunk) {
+    double doubleSum = total.doubleSum;
+    for (double value : chunk.doubles) {
+        doubleSum += value;
+    }
+    total += chunk.summary;
+    total.doubleSum = doubleSum;
+}
+
+ValidationReport validateLines(std::string_view text) {
+    ValidationReport report;
+    while (!text.empty()) {
+        std::size_t newline = text.find('\n');
+        if (newline == std::string_view::npos) {
+            validateLine(report, text);   // The last line, without '\n'
+            break;
+        }
+        validateLine(report, text.substr(0, newline));
+        text.remove_prefix(newline + 1);
+    }
+    return report;
+}
+
+// Reads the whole input in blocks of about chunkBytes that end right after
+// a separator and calls onBlock(std::vector<char>) for each. The last
+// block ends wherever the input does. A block grows when one token or
+// line does not fit.
+template <typename IsSeparator, typename OnBlock>
+void forEachBlock(BlockReader& reader, std::size_t chunkBytes, IsSeparator isSeparator, OnBlock onBlock) {
+    std::vector<char> carried;
+    for (;;) {
+        std::vector<char> block(std::max(chunkBytes, 2 * carried.size()));
+        std::copy(carried.begin(), carried.end(), block.begin());
+        std::size_t filled = carried.size();
+        std::size_t count = 0;
+        while (filled < block.size() && (count = reader.read(block.data() + filled, block.size() - filled)) > 0) {
+            filled += count;
+        }
+        if (filled < block.size()) {   // The end of the input
+            if (filled > 0) {
+                block.resize(filled);
+                onBlock(std::move(block));
+            }
+            return;
+        }
+        std::size_t cut = filled;
+        while (cut > 0 && !isSeparator(block[cut - 1])) {
+            cut--;
+        }
+        if (cut == 0) {
+            carried = std::move(block);
+            continue;
+        }
+        carried.assign(block.begin() + static_cast<std::ptrdiff_t>(cut), block.end());
+        block.resize(cut);
+        onBlock(std::move(block));
+    }
+}
+
+}
+
+ParseSummary summarizeParallel(ThreadPool& pool, std::string_view input, std::size_t chunkBytes) {
+    ParseSummary total;
+    auto chunks = orderedChunks<TokenChunk>(pool, [&total](const TokenChunk& chunk) { foldChunk(total, chunk); });
+    std::size_t begin = 0;
+    while (begin < input.size()) {
+        std::size_t end = std::min(input.size(), begin + std::max<std::size_t>(chunkBytes, 1));
+        while (end < input.size() && !isSpace(input[end])) {
+            end++;
+        }
+        std::string_view text = input.substr(begin, end - begin);
+        chunks.submit([text] { return parseChunk(text); });
+        begin = end;
+    }
+    chunks.finish();
+    return total;
+}
+
+ParseSummary summarizeBlocksParallel(ThreadPool& pool, BlockReader& reader, std::size_t chunkBytes) {
+    ParseSummary total;
+    auto chunks = orderedChunks<TokenChunk>(pool, [&total](const TokenChunk& chunk) { foldChunk(total, chunk); });
+    forEachBlock(reader, chunkBytes, isSpace, [&chunks](std::vector<char> block) {
+        chunks.submit([block = std::move(block)] { return parseChunk({block.data(), block.size()}); });
+    });
+    chunks.finish();
+    return total;
+}
+
+ValidationReport validatePositiveIntegersParallel(ThreadPool& pool, BlockReader& reader, std::size_t chunkBytes) {
+    ValidationReport total;
+    auto chunks = orderedChunks<ValidationReport>(pool, [&total](const ValidationReport& part) { total += part; });
+    forEachBlock(reader, chunkBytes, [](char c) { return c == '\n'; }, [&chunks](std::vector<char> block) {
+        chunks.submit([block = std::move(block)] { return validateLines({block.data(), block.size()}); });
+    });
+    chunks.finish();
+    total.bytes = reader.bytesRead();
+    return total;
+}
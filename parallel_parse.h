@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "bulk_input.h"
+#include "fast_parse.h"
+#include "thread_pool.h"
+
+/*
+ * The --input and --mmap parsers on every core (like Parallel.ForEach over
+ * the partitions of a file in C#).
+ *
+ * The input is cut into chunks of about kParseChunkBytes, each ending at a
+ * separator (whitespace for tokens, '\n' for lines) so no token or line is
+ * split. The chunks are parsed concurrently on a ThreadPool, each into its
+ * own result, and folded in file order on the calling thread while later
+ * chunks are still being parsed. At most a few chunks per thread are in
+ * flight, so memory stays bounded however large the file is.
+ *
+ * The results are identical to the serial functions, bit for bit: a chunk
+ * keeps its doubles in a vector and the fold adds them to the running sum
+ * in file order. Summing each chunk on its own and adding the partial
+ * sums would round differently.
+ */
+inline constexpr std::size_t kParseChunkBytes = 4 << 20;   // 4 MiB
+
+// Same result as summarize(input)
+ParseSummary summarizeParallel(ThreadPool& pool, std::string_view input,
+                               std::size_t chunkBytes = kParseChunkBytes);
+
+// Same result as summarizeBlocks(reader); the reads stay on this thread
+ParseSummary summarizeBlocksParallel(ThreadPool& pool, BlockReader& reader,
+                                     std::size_t chunkBytes = kParseChunkBytes);
+
+// Same report as validatePositiveIntegers(reader)
+ValidationReport validatePositiveIntegersParallel(ThreadPool& pool, BlockReader& reader,
+                                                  std::size_t chunkBytes = kParseChunkBytes);
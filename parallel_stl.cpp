@@ -0,0 +1,234 @@
+#include "parallel_stl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "kernels.h"
+#include "thread_pool.h"
+
+#if defined(MYPROJECT_HAS_STD_EXECUTION)
+#include <execution>
+#endif
+#if defined(MYPROJECT_HAS_TBB)
+#include <tbb/global_control.h>
+#endif
+
+namespace parallel {
+
+namespace {
+
+std::int32_t doubled(std::int32_t x) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) * 2u);
+}
+
+#if !defined(MYPROJECT_HAS_STD_EXECUTION)
+// ----- The thread-pool fallback -----
+// [begin, end) of chunk `index` when n items are split into `count` chunks
+struct Chunk {
+    std::size_t begin;
+    std::size_t end;
+};
+
+Chunk chunkOf(std::size_t n, std::size_t count, std::size_t index) {
+    return Chunk{n * index / count, n * (index + 1) / count};
+}
+
+// Runs body(chunk) for `count` chunks of n items on the pool and waits.
+// The first exception thrown by a chunk is rethrown here.
+template <typename F>
+void forEachChunk(ThreadPool& pool, std::size_t n, std::size_t count, F body) {
+    std::vector<PoolTask<void>> done;
+    done.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        Chunk chunk = chunkOf(n, count, i);
+        done.push_back(pool.submit([body, chunk] { body(chunk); }));
+    }
+    for (PoolTask<void>& f : done) {
+        f.get();
+    }
+}
+
+// Below this many items a chunk is not worth a task
+constexpr std::size_t kMinChunk = 16 * 1024;
+
+std::size_t chunkCount(std::size_t n, unsigned threads) {
+    return std::max<std::size_t>(1, std::min<std::size_t>(threads, n / kMinChunk));
+}
+#endif
+
+#if defined(MYPROJECT_HAS_STD_EXECUTION)
+// Calls body(policyObject) with the std::execution object for `policy`
+template <typename F>
+void withStandardPolicy(Policy policy, unsigned threads, F&& body) {
+#if defined(MYPROJECT_HAS_TBB)
+    // The TBB backend otherwise uses every core
+    tbb::global_control limit(tbb::global_control::max_allowed_parallelism, threads);
+#else
+    (void)threads;
+#endif
+    switch (policy) {
+        case Policy::Seq:
+            return body(std::execution::seq);
+        case Policy::Par:
+            return body(std::execution::par);
+        case Policy::ParUnseq:
+            return body(std::execution::par_unseq);
+    }
+}
+#endif
+
+}
+
+Policy parsePolicy(std::string_view name) {
+    if (name == "seq") {
+        return Policy::Seq;
+    }
+    if (name == "par") {
+        return Policy::Par;
+    }
+    if (name == "par_unseq") {
+        return Policy::ParUnseq;
+    }
+    throw std::invalid_argument("unknown policy '" + std::string(name) + "' (seq, par or par_unseq)");
+}
+
+const char* policyName(Policy policy) {
+    switch (policy) {
+        case Policy::Seq: return "seq";
+        case Policy::Par: return "par";
+        case Policy::ParUnseq: return "par_unseq";
+    }
+    return "unknown";
+}
+
+bool usesStandardPolicies() {
+#if defined(MYPROJECT_HAS_STD_EXECUTION)
+    return true;
+#else
+    return false;
+#endif
+}
+
+ParallelAlgorithms::ParallelAlgorithms(Policy policy, unsigned threadCount)
+    : policy_(policy), threadCount_(std::max(threadCount, 1u)) {
+    if (!usesStandardPolicies() && policy_ != Policy::Seq) {
+        pool_ = std::make_unique<ThreadPool>(threadCount_);
+    }
+}
+
+ParallelAlgorithms::~ParallelAlgorithms() = default;
+
+void ParallelAlgorithms::doubleValues(std::span<const std::int32_t> in, std::span<std::int32_t> out) {
+    if (out.size() < in.size()) {
+        throw std::invalid_argument("doubleValues: output is shorter than input");
+    }
+#if defined(MYPROJECT_HAS_STD_EXECUTION)
+    withStandardPolicy(policy_, threadCount_, [&](const auto& policy) {
+        std::transform(policy, in.begin(), in.end(), out.begin(), doubled);
+    });
+#else
+    if (!pool_) {
+        std::transform(in.begin(), in.end(), out.begin(), doubled);
+        return;
+    }
+    const bool simd = policy_ == Policy::ParUnseq;
+    forEachChunk(*pool_, in.size(), chunkCount(in.size(), threadCount_), [in, out, simd](Chunk c) {
+        std::span<const std::int32_t> from = in.subspan(c.begin, c.end - c.begin);
+        if (simd) {
+            kernels::doubleValues(from, out.subspan(c.begin));
+        } else {
+            std::transform(from.begin(), from.end(), out.begin() + c.begin, doubled);
+        }
+    });
+#endif
+}
+
+std::size_t ParallelAlgorithms::findValue(std::span<const std::int32_t> values, std::int32_t needle) {
+#if defined(MYPROJECT_HAS_STD_EXECUTION)
+    std::size_t position = values.size();
+    withStandardPolicy(policy_, threadCount_, [&](const auto& policy) {
+        position = static_cast<std::size_t>(std::find(policy, values.begin(), values.end(), needle) - values.begin());
+    });
+    return position;
+#else
+    if (!pool_) {
+        return static_cast<std::size_t>(std::find(values.begin(), values.end(), needle) - values.begin());
+    }
+    // The leftmost match found so far. A chunk scans in blocks and gives up
+    // as soon as a match left of its next block is known: nothing it could
+    // still find would be the first one.
+    constexpr std::size_t kBlock = 4096;
+    std::atomic<std::size_t> first{values.size()};
+    const bool simd = policy_ == Policy::ParUnseq;
+    forEachChunk(*pool_, values.size(), chunkCount(values.size(), threadCount_), [&, simd](Chunk c) {
+        for (std::size_t block = c.begin; block < c.end; block += kBlock) {
+            if (first.load(std::memory_order_relaxed) < block) {
+                return;
+            }
+            std::span<const std::int32_t> part = values.subspan(block, std::min(kBlock, c.end - block));
+            std::size_t found = simd ? kernels::findValue(part, needle)
+                                     : static_cast<std::size_t>(std::find(part.begin(), part.end(), needle) - part.begin());
+            if (found < part.size()) {
+                std::size_t position = block + found;
+                std::size_t current = first.load(std::memory_order_relaxed);
+                while (position < current && !first.compare_exchange_weak(current, position)) {
+                }
+                return;
+            }
+        }
+    });
+    return first.load();
+#endif
+}
+
+void ParallelAlgorithms::sortValues(std::span<std::int32_t> values) {
+#if defined(MYPROJECT_HAS_STD_EXECUTION)
+    withStandardPolicy(policy_, threadCount_, [&](const auto& policy) {
+        std::sort(policy, values.begin(), values.end());
+    });
+#else
+    const std::size_t n = values.size();
+    const std::size_t runs = pool_ ? chunkCount(n, threadCount_) : 1;
+    if (runs == 1) {
+        std::sort(values.begin(), values.end());
+        return;
+    }
+
+    // 1. Sort each chunk on its own thread
+    forEachChunk(*pool_, n, runs, [values](Chunk c) {
+        std::sort(values.begin() + c.begin, values.begin() + c.end);
+    });
+
+    // 2. Merge neighbouring runs in parallel, halving the number of runs
+    //    each round, ping-ponging between `values` and a scratch buffer
+    std::vector<std::int32_t> scratch(n);
+    std::span<std::int32_t> from = values;
+    std::span<std::int32_t> to = scratch;
+    for (std::size_t width = 1; width < runs; width *= 2) {
+        const std::size_t pairs = (runs + 2 * width - 1) / (2 * width);
+        std::vector<PoolTask<void>> done;
+        done.reserve(pairs);
+        for (std::size_t p = 0; p < pairs; p++) {
+            std::size_t begin = chunkOf(n, runs, p * 2 * width).begin;
+            std::size_t middle = p * 2 * width + width < runs ? chunkOf(n, runs, p * 2 * width + width).begin : n;
+            std::size_t end = p * 2 * width + 2 * width < runs ? chunkOf(n, runs, p * 2 * width + 2 * width).begin : n;
+            done.push_back(pool_->submit([from, to, begin, middle, end] {
+                std::merge(from.begin() + begin, from.begin() + middle,
+                           from.begin() + middle, from.begin() + end, to.begin() + begin);
+            }));
+        }
+        for (PoolTask<void>& f : done) {
+            f.get();
+        }
+        std::swap(from, to);
+    }
+    if (from.data() != values.data()) {
+        std::copy(from.begin(), from.end(), values.begin());
+    }
+#endif
+}
+
+}
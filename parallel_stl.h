@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+
+class ThreadPool;
+
+/*
+ * The demonstrateStl algorithms (doubling transform, find, sort) with a
+ * C++17 execution policy, like std::sort(std::execution::par, ...).
+ *
+ * When the standard library has a parallel backend (libstdc++ needs TBB,
+ * see CMakeLists.txt) the std:: algorithms are called with the real policy
+ * objects. Otherwise ParallelAlgorithms falls back to its own ThreadPool:
+ * a chunked transform, a find whose chunks stop early once a match is known
+ * to exist further left, and a merge sort (sort the chunks, then merge
+ * pairs of runs in parallel). In the fallback, par_unseq additionally uses
+ * the SIMD kernels from kernels.h inside each chunk.
+ */
+namespace parallel {
+
+enum class Policy { Seq, Par, ParUnseq };
+
+// "seq", "par" or "par_unseq"; throws std::invalid_argument otherwise
+Policy parsePolicy(std::string_view name);
+const char* policyName(Policy policy);
+
+// True when the std:: execution policies are used, false for the thread pool fallback
+bool usesStandardPolicies();
+
+class ParallelAlgorithms {
+  public:
+      // threadCount caps the threads used (the pool size in the fallback)
+      ParallelAlgorithms(Policy policy, unsigned threadCount);
+      ~ParallelAlgorithms();
+
+      ParallelAlgorithms(const ParallelAlgorithms&) = delete;
+      ParallelAlgorithms& operator=(const ParallelAlgorithms&) = delete;
+
+      // Same results as the sequential std:: algorithms (doubling wraps around)
+      void doubleValues(std::span<const std::int32_t> in, std::span<std::int32_t> out);
+      std::size_t findValue(std::span<const std::int32_t> values, std::int32_t needle);
+      void sortValues(std::span<std::int32_t> values);
+
+      Policy policy() const { return policy_; }
+      unsigned threadCount() const { return threadCount_; }
+
+  private:
+      Policy policy_;
+      unsigned threadCount_;
+      std::unique_ptr<ThreadPool> pool_;  // Only for the fallback with a parallel policy
+};
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "interned_string.h"
+#include "output_sink.h"
+
+// ----- Classes and OOP -----
+
+// Logging policies: what a Person or Employee prints when it is created or
+// destroyed. The policy is a template parameter (a compile-time "strategy"),
+// so a silent Person pays nothing for the logging it does not do.
+struct ConsoleLogging {
+    static void personCreated(const std::string& name) {
+        output() << "Person created: " << name << '\n';
+    }
+    static void personDestroyed(const std::string& name) {
+        output() << "Person destroyed: " << name << '\n';
+    }
+    static void employeeCreated(std::string_view company) {
+        output() << "Employee created at " << company << '\n';
+    }
+};
+
+// For bulk use (pools, tables, benchmarks) where millions of lines would drown everything
+struct NoLogging {
+    static void personCreated(const std::string&) {}
+    static void personDestroyed(const std::string&) {}
+    static void employeeCreated(std::string_view) {}
+};
+
+// Helpers for building introductions into a reusable std::string
+namespace introduction {
+
+inline void appendNumber(std::string& out, int value) {
+    char digits[16];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    out.append(digits, end);
+}
+
+inline std::size_t numberLength(int value) {
+    unsigned magnitude = value < 0 ? 0u - static_cast<unsigned>(value) : static_cast<unsigned>(value);
+    std::size_t length = value < 0 ? 2 : 1;
+    while (magnitude >= 10) {
+        magnitude /= 10;
+        length++;
+    }
+    return length;
+}
+
+// "Hi, I'm <name> and I'm <age> years old."
+inline void appendPerson(std::string& out, std::string_view name, int age) {
+    out += "Hi, I'm ";
+    out += name;
+    out += " and I'm ";
+    appendNumber(out, age);
+    out += " years old.";
+}
+
+inline std::size_t personLength(std::string_view name, int age) {
+    return 8 + name.size() + 9 + numberLength(age) + 11;
+}
+
+// "Hi, I'm <name>, <age> years old, and I work at <company>."
+inline void appendEmployee(std::string& out, std::string_view name, int age, std::string_view company) {
+    out += "Hi, I'm ";
+    out += name;
+    out += ", ";
+    appendNumber(out, age);
+    out += " years old, and I work at ";
+    out += company;
+    out += '.';
+}
+
+inline std::size_t employeeLength(std::string_view name, int age, std::string_view company) {
+    return 8 + name.size() + 2 + numberLength(age) + 26 + company.size() + 1;
+}
+
+}
+
+// Class definition (similar to C# classes, different from JavaScript classes)
+template <typename Logging = ConsoleLogging>
+class BasicPerson {
+  private:
+      std::string name_;
+      int age_;
+
+  public:
+      // Constructor
+      // The name is taken by value and then moved into place ("sink"
+      // parameter): a temporary or std::move'd string is moved twice and
+      // copied never, and a const reference argument is copied exactly once.
+      BasicPerson(std::string n, int a) : name_(std::move(n)), age_(a) {
+          Logging::personCreated(name_);
+      }
+
+      // Destructor (called automatically when object is destroyed)
+      // No equivalent in C# (handled by garbage collection) or JavaScript
+      ~BasicPerson() {
+          Logging::personDestroyed(name_);
+      }
+
+      // Declaring a destructor switches off the compiler-generated move
+      // operations, so ask for them explicitly: moving a Person (e.g. when
+      // a vector grows) then steals the name instead of copying it
+      BasicPerson(const BasicPerson&) = default;
+      BasicPerson(BasicPerson&&) noexcept = default;
+      BasicPerson& operator=(const BasicPerson&) = default;
+      BasicPerson& operator=(BasicPerson&&) noexcept = default;
+
+      // Member functions (methods)
+      void introduce() const {
+          output() << "Hi, I'm " << name_ << " and I'm " << age_ << " years old." << '\n';
+      }
+
+      // The introduce() text (without the newline) appended to `out`, and its length
+      void appendIntroduction(std::string& out) const { introduction::appendPerson(out, name_, age_); }
+      std::size_t introductionLength() const { return introduction::personLength(name_, age_); }
+
+      // Getters and setters (similar to C# properties)
+      // name() is a read-only view, getName() a reference: neither copies
+      std::string_view name() const { return name_; }
+      const std::string& getName() const { return name_; }
+      void setName(std::string n) { name_ = std::move(n); }
+
+      int getAge() const { return age_; }
+      void setAge(int a) { age_ = a; }
+};
+
+// Inheritance example
+// The company is interned (see interned_string.h): thousands of employees
+// at "Acme Inc" share one copy of the text and each keeps a 4-byte id.
+template <typename Logging = ConsoleLogging>
+class BasicEmployee : public BasicPerson<Logging> {
+  private:
+      InternedString company_;
+
+  public:
+      BasicEmployee(std::string n, int a, std::string_view c)
+          : BasicPerson<Logging>(std::move(n), a), company_(c) {
+          Logging::employeeCreated(company());
+      }
+
+      // Override method
+      // (this-> is needed because the base class depends on a template parameter)
+      // Note: introduce() is not virtual, so this *hides* Person::introduce
+      // rather than overriding it. Through a Person& the Person version runs
+      // (see person_dispatch.h for ways to get the right one without virtual).
+      void introduce() const {
+          output() << "Hi, I'm " << this->name() << ", " << this->getAge()
+                   << " years old, and I work at " << company() << "." << '\n';
+      }
+
+      void appendIntroduction(std::string& out) const {
+          introduction::appendEmployee(out, this->name(), this->getAge(), company());
+      }
+      std::size_t introductionLength() const {
+          return introduction::employeeLength(this->name(), this->getAge(), company());
+      }
+
+      // Both are views into the shared pool, valid for the whole program
+      std::string_view company() const { return company_.view(); }
+      std::string_view getCompany() const { return company(); }
+      void setCompany(std::string_view c) { company_ = InternedString(c); }
+};
+
+// The classes used throughout the tutorial: they log every construction
+using Person = BasicPerson<>;
+using Employee = BasicEmployee<>;
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "person.h"
+
+/*
+ * Three ways to call the right introduce() on a mix of people.
+ *
+ * Employee::introduce() in person.h hides Person::introduce() instead of
+ * overriding it, so the static type decides which one runs. The usual fix
+ * is a virtual function (as in C#), but then every call is an indirect
+ * call through the vtable that the compiler cannot inline. All three
+ * approaches below reuse the person.h types as they are; the last two
+ * resolve the call at compile time:
+ *
+ *  1. VirtualPersonOf<P>: wraps a Person or Employee behind the abstract
+ *     VirtualPerson (think of a C# interface), kept here for comparison.
+ *  2. CRTP (Curiously Recurring Template Pattern): StaticPersonBase<Derived>
+ *     calls into Derived through a static_cast, so there is nothing virtual
+ *     left. Each type lives in its own container (StaticRoster).
+ *  3. AnyPerson = std::variant<Person, Employee>: one container in any
+ *     order, with std::visit choosing the alternative (a switch on the
+ *     variant's index that the compiler can inline).
+ */
+
+// ----- 1. Virtual dispatch -----
+class VirtualPerson {
+  public:
+      virtual ~VirtualPerson() = default;
+
+      virtual void introduce() const = 0;
+      virtual void appendIntroduction(std::string& out) const = 0;
+      virtual std::size_t introductionLength() const = 0;
+};
+
+// P is BasicPerson<Logging> or BasicEmployee<Logging>; the constructor
+// arguments are passed straight on to it
+template <typename P>
+class VirtualPersonOf final : public VirtualPerson {
+  private:
+      P person_;
+
+  public:
+      template <typename... Args>
+      explicit VirtualPersonOf(Args&&... args) : person_(std::forward<Args>(args)...) {}
+
+      void introduce() const override { person_.introduce(); }
+      void appendIntroduction(std::string& out) const override { person_.appendIntroduction(out); }
+      std::size_t introductionLength() const override { return person_.introductionLength(); }
+
+      const P& person() const { return person_; }
+};
+
+// ----- 2. Static polymorphism (CRTP) -----
+template <typename Derived>
+class StaticPersonBase {
+  public:
+      void introduce() const { self().introduceImpl(); }
+      void appendIntroduction(std::string& out) const { self().appendIntroductionImpl(out); }
+      std::size_t introductionLength() const { return self().introductionLengthImpl(); }
+
+  private:
+      const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+template <typename P>
+class StaticPersonOf final : public StaticPersonBase<StaticPersonOf<P>> {
+  private:
+      P person_;
+
+  public:
+      template <typename... Args>
+      explicit StaticPersonOf(Args&&... args) : person_(std::forward<Args>(args)...) {}
+
+      // Writes straight to output(), like the wrapped type does
+      void introduceImpl() const { person_.introduce(); }
+      void appendIntroductionImpl(std::string& out) const { person_.appendIntroduction(out); }
+      std::size_t introductionLengthImpl() const { return person_.introductionLength(); }
+
+      const P& person() const { return person_; }
+};
+
+// CRTP types share no base class, so a mixed roster keeps one vector per
+// type. Visiting is then a plain loop per vector with both calls inlined.
+template <typename Logging = NoLogging>
+struct StaticRoster {
+    std::vector<StaticPersonOf<BasicPerson<Logging>>> people;
+    std::vector<StaticPersonOf<BasicEmployee<Logging>>> employees;
+
+    template <typename F>
+    void forEach(F&& visit) const {
+        for (const auto& p : people) {
+            visit(p);
+        }
+        for (const auto& e : employees) {
+            visit(e);
+        }
+    }
+};
+
+// ----- 3. std::variant + std::visit -----
+template <typename Logging = NoLogging>
+using AnyPerson = std::variant<BasicPerson<Logging>, BasicEmployee<Logging>>;
+
+// Runs the introduce() of whatever the variant holds
+template <typename Logging>
+void introduce(const AnyPerson<Logging>& person) {
+    std::visit([](const auto& p) { p.introduce(); }, person);
+}
+
+template <typename Logging>
+void appendIntroduction(const AnyPerson<Logging>& person, std::string& out) {
+    std::visit([&out](const auto& p) { p.appendIntroduction(out); }, person);
+}
+
+template <typename Logging>
+std::size_t introductionLength(const AnyPerson<Logging>& person) {
+    return std::visit([](const auto& p) { return p.introductionLength(); }, person);
+}
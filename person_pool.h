@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "person.h"
+
+/*
+ * A monotonic arena of T objects (similar in spirit to an object pool in C#,
+ * but without the per-object heap allocation).
+ *
+ * Objects are constructed in place in large contiguous chunks, so creating
+ * one is a pointer bump instead of a trip to operator new, references stay
+ * valid (chunks never move) and iteration walks memory in order. There is
+ * no way to free a single object: everything is released at once.
+ *
+ * The first chunk is small and each new one is twice the size of the last
+ * (like std::vector's growth), up to kMaxChunkSize: a handful of people
+ * costs a few KB, a million of them still only a few dozen allocations.
+ */
+template <typename T>
+class ObjectArena {
+  public:
+      static constexpr std::size_t kFirstChunkSize = 64;       // Objects in the first chunk
+      static constexpr std::size_t kMaxChunkSize = 64 * 1024;  // Growth stops doubling here
+
+      // Callers that know how many objects are coming can pass that as the
+      // first chunk size and get them all in one allocation
+      explicit ObjectArena(std::size_t firstChunkSize = kFirstChunkSize)
+          : firstChunkSize_(firstChunkSize > 0 ? firstChunkSize : 1) {}
+      ~ObjectArena() { release(); }
+
+      ObjectArena(const ObjectArena&) = delete;
+      ObjectArena& operator=(const ObjectArena&) = delete;
+
+      template <typename... Args>
+      T& emplace(Args&&... args) {
+          if (chunks_.empty() || usedInLast_ == chunks_[activeChunk_].size) {
+              nextChunk();
+          }
+          T* slot = reinterpret_cast<T*>(chunks_[activeChunk_].slots.get()) + usedInLast_;
+          T* object = ::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+          usedInLast_++;
+          size_++;
+          return *object;
+      }
+
+      // Visits every object in construction order
+      template <typename F>
+      void forEach(F&& visit) {
+          forEachChunk([&visit](T* first, std::size_t count) {
+              for (std::size_t i = 0; i < count; i++) {
+                  visit(first[i]);
+              }
+          });
+      }
+
+      // Visits the arena as contiguous runs: visit(T* first, std::size_t count)
+      template <typename F>
+      void forEachChunk(F&& visit) {
+          for (std::size_t c = 0; c < chunks_.size() && c <= activeChunk_; c++) {
+              std::size_t count = c == activeChunk_ ? usedInLast_ : chunks_[c].size;
+              if (count > 0) {
+                  visit(reinterpret_cast<T*>(chunks_[c].slots.get()), count);
+              }
+          }
+      }
+
+      // Destroys every object. Trivially destructible objects are simply
+      // forgotten (O(1)); others still need their destructors run (e.g. a
+      // std::string that owns heap memory). Either way the chunks are kept
+      // and reused, so refilling the arena allocates nothing.
+      void release() {
+          if constexpr (!std::is_trivially_destructible_v<T>) {
+              forEach([](T& object) { object.~T(); });
+          }
+          activeChunk_ = 0;
+          usedInLast_ = 0;
+          size_ = 0;
+      }
+
+      // release() and give the chunks back to the heap
+      void shrink() {
+          release();
+          chunks_.clear();
+      }
+
+      std::size_t size() const { return size_; }
+      std::size_t capacity() const {
+          std::size_t total = 0;
+          for (const Chunk& chunk : chunks_) {
+              total += chunk.size;
+          }
+          return total;
+      }
+
+  private:
+      // Raw, correctly aligned storage for one object
+      struct alignas(T) Slot {
+          std::byte bytes[sizeof(T)];
+      };
+
+      struct Chunk {
+          std::unique_ptr<Slot[]> slots;
+          std::size_t size;  // Objects it can hold
+      };
+
+      // Allocates before touching activeChunk_, so a bad_alloc leaves the arena as it was.
+      // After release() the chunks already allocated are refilled first.
+      void nextChunk() {
+          const std::size_t next = chunks_.empty() ? 0 : activeChunk_ + 1;
+          if (next == chunks_.size()) {
+              const std::size_t size = chunks_.empty()
+                  ? firstChunkSize_
+                  : std::max(chunks_.back().size, std::min(chunks_.back().size * 2, kMaxChunkSize));
+              chunks_.push_back(Chunk{std::make_unique_for_overwrite<Slot[]>(size), size});
+          }
+          activeChunk_ = next;
+          usedInLast_ = 0;
+      }
+
+      std::vector<Chunk> chunks_;
+      std::size_t firstChunkSize_;
+      std::size_t activeChunk_ = 0;
+      std::size_t usedInLast_ = 0;
+      std::size_t size_ = 0;
+};
+
+/*
+ * Arena storage for large populations of people. The logging policy is
+ * NoLogging by default: nobody wants ten million "Person created" lines.
+ */
+template <typename Logging = NoLogging>
+class PersonPool {
+  public:
+      using PersonType = BasicPerson<Logging>;
+      using EmployeeType = BasicEmployee<Logging>;
+
+      // The sizes of the first person and employee chunks; later ones grow from there
+      explicit PersonPool(std::size_t firstPeople = ObjectArena<PersonType>::kFirstChunkSize,
+                          std::size_t firstEmployees = ObjectArena<EmployeeType>::kFirstChunkSize)
+          : people_(firstPeople), employees_(firstEmployees) {}
+
+      PersonType& addPerson(std::string name, int age) {
+          return people_.emplace(std::move(name), age);
+      }
+
+      EmployeeType& addEmployee(std::string name, int age, std::string_view company) {
+          return employees_.emplace(std::move(name), age, company);
+      }
+
+      template <typename F>
+      void forEachPerson(F&& visit) { people_.forEach(std::forward<F>(visit)); }
+
+      template <typename F>
+      void forEachEmployee(F&& visit) { employees_.forEach(std::forward<F>(visit)); }
+
+      std::size_t personCount() const { return people_.size(); }
+      std::size_t employeeCount() const { return employees_.size(); }
+
+      // Drops everybody at once; the memory is kept for the next population
+      void release() {
+          people_.release();
+          employees_.release();
+      }
+
+  private:
+      ObjectArena<PersonType> people_;
+      ObjectArena<EmployeeType> employees_;
+};
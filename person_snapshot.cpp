@@ -0,0 +1,297 @@
+#include "person_snapshot.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'T', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr std::uint32_t kByteOrder = 0x01020304;   // Reads back as 0x04030201 on the other byte order
+constexpr std::size_t kAlignment = 64;
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t rows;
+    std::uint64_t names;
+    std::uint64_t nameBytes;
+    std::uint64_t companies;
+    std::uint64_t companyBytes;
+    std::uint64_t columnChecksum;   // ages, name ids, company ids (with the gaps)
+    std::uint64_t stringChecksum;   // offsets and characters of both pools
+    std::uint64_t headerChecksum;   // Everything above
+};
+static_assert(sizeof(Header) == 80, "the header layout is part of the file format");
+
+std::size_t alignUp(std::size_t offset) {
+    return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// Where each section starts, from the counts in the header
+struct Layout {
+    std::size_t ages;
+    std::size_t nameIds;
+    std::size_t companyIds;
+    std::size_t nameOffsets;
+    std::size_t companyOffsets;
+    std::size_t nameChars;
+    std::size_t companyChars;
+    std::size_t end;
+};
+
+Layout layoutOf(const Header& header) {
+    Layout layout{};
+    layout.ages = alignUp(sizeof(Header));
+    layout.nameIds = alignUp(layout.ages + header.rows * sizeof(int));
+    layout.companyIds = alignUp(layout.nameIds + header.rows * sizeof(PersonTable::Id));
+    layout.nameOffsets = alignUp(layout.companyIds + header.rows * sizeof(PersonTable::Id));
+    layout.companyOffsets = alignUp(layout.nameOffsets + (header.names + 1) * sizeof(std::uint64_t));
+    layout.nameChars = alignUp(layout.companyOffsets + (header.companies + 1) * sizeof(std::uint64_t));
+    layout.companyChars = alignUp(layout.nameChars + header.nameBytes);
+    layout.end = alignUp(layout.companyChars + header.companyBytes);
+    return layout;
+}
+
+// Fletcher-style over 64-bit words: a running sum and a sum of the running
+// sums, so swapped or shifted data changes it too. About one cycle per
+// 8 bytes, far cheaper than a CRC and enough to catch a damaged file.
+class Checksum {
+  public:
+      void add(const void* data, std::size_t size) {
+          const auto* bytes = static_cast<const unsigned char*>(data);
+          while (size > 0 && pendingSize_ > 0) {
+              pending_[pendingSize_++] = *bytes++;
+              size--;
+              if (pendingSize_ == 8) {
+                  addWord(pending_.data());
+                  pendingSize_ = 0;
+              }
+          }
+          for (; size >= 8; bytes += 8, size -= 8) {
+              addWord(bytes);
+          }
+          if (size > 0) {
+              std::memcpy(pending_.data(), bytes, size);
+              pendingSize_ = size;
+          }
+      }
+
+      // Every checksummed region is a whole number of words
+      std::uint64_t value() const { return sumOfSums_ ^ (sum_ << 32 | sum_ >> 32); }
+
+  private:
+      void addWord(const unsigned char* bytes) {
+          std::uint64_t word;
+          std::memcpy(&word, bytes, sizeof(word));
+          sum_ += word;
+          sumOfSums_ += sum_;
+      }
+
+      std::uint64_t sum_ = 0;
+      std::uint64_t sumOfSums_ = 0;
+      std::array<unsigned char, 8> pending_{};
+      std::size_t pendingSize_ = 0;
+};
+
+std::uint64_t checksumOf(std::string_view bytes) {
+    Checksum checksum;
+    checksum.add(bytes.data(), bytes.size());
+    return checksum.value();
+}
+
+std::uint64_t headerChecksum(const Header& header) {
+    return checksumOf(std::string_view(reinterpret_cast<const char*>(&header), offsetof(Header, headerChecksum)));
+}
+
+// Writes one section followed by zeros up to the next multiple of 64,
+// adding both to the checksum
+template <typename T>
+void writeSection(std::ofstream& out, std::size_t& offset, std::span<const T> data, Checksum& checksum) {
+    static constexpr char kZeros[kAlignment] = {};
+    const std::size_t size = data.size_bytes();
+    const std::size_t padding = alignUp(offset + size) - offset - size;
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(size));
+    out.write(kZeros, static_cast<std::streamsize>(padding));
+    checksum.add(data.data(), size);
+    checksum.add(kZeros, padding);
+    offset += size + padding;
+}
+
+std::runtime_error invalid(const std::string& path, const std::string& problem) {
+    return std::runtime_error("'" + path + "' is not a valid person snapshot: " + problem);
+}
+
+template <typename T>
+std::span<const T> column(std::string_view bytes, std::size_t offset, std::size_t count) {
+    return {reinterpret_cast<const T*>(bytes.data() + offset), count};
+}
+
+}
+
+void saveSnapshot(const PersonTable& table, const std::string& path) {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("cannot write '" + temporary + "'");
+        }
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kSnapshotVersion;
+        header.byteOrder = kByteOrder;
+        header.rows = table.size();
+        header.names = table.names().size();
+        header.nameBytes = table.names().characters().size();
+        header.companies = table.companies().size();
+        header.companyBytes = table.companies().characters().size();
+
+        // The sections first, behind room for the header, which needs their checksums
+        std::size_t offset = 0;
+        Checksum unused;
+        const std::array<char, sizeof(Header)> placeholder{};
+        writeSection(out, offset, std::span<const char>(placeholder), unused);
+        Checksum columns;
+        writeSection(out, offset, table.ages(), columns);
+        writeSection(out, offset, table.nameIds(), columns);
+        writeSection(out, offset, table.companyIds(), columns);
+        Checksum strings;
+        writeSection(out, offset, std::span<const std::uint64_t>(table.names().offsets()), strings);
+        writeSection(out, offset, std::span<const std::uint64_t>(table.companies().offsets()), strings);
+        writeSection(out, offset, std::span<const char>(table.names().characters()), strings);
+        writeSection(out, offset, std::span<const char>(table.companies().characters()), strings);
+
+        header.columnChecksum = columns.value();
+        header.stringChecksum = strings.value();
+        header.headerChecksum = headerChecksum(header);
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("error while writing '" + temporary + "'");
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        throw std::runtime_error("cannot replace '" + path + "'");
+    }
+}
+
+PersonSnapshot::PersonSnapshot(const std::string& path) {
+    std::string_view bytes;
+    if constexpr (MappedFile::kSupported) {
+        file_.emplace(path);
+        bytes = file_->data();
+        mapped_ = true;
+    } else {
+        // Whole words, so the columns are aligned as on a mapping
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw std::runtime_error("cannot open '" + path + "'");
+        }
+        const auto size = static_cast<std::size_t>(in.tellg());
+        buffer_.resize((size + 7) / 8);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(size));
+        if (!in) {
+            throw std::runtime_error("error while reading '" + path + "'");
+        }
+        bytes = std::string_view(reinterpret_cast<const char*>(buffer_.data()), size);
+    }
+
+    Header header;
+    if (bytes.size() < sizeof(header)) {
+        throw invalid(path, "too short for the header");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw invalid(path, "wrong magic number");
+    }
+    if (header.byteOrder != kByteOrder) {
+        throw invalid(path, "written on a machine with the other byte order");
+    }
+    if (header.version != kSnapshotVersion) {
+        throw invalid(path, "version " + std::to_string(header.version) + ", expected "
+                            + std::to_string(kSnapshotVersion));
+    }
+    if (header.headerChecksum != headerChecksum(header)) {
+        throw invalid(path, "header checksum mismatch");
+    }
+    // Counts no larger than the file keep the layout arithmetic from overflowing
+    for (std::uint64_t count : {header.rows, header.names, header.nameBytes, header.companies, header.companyBytes}) {
+        if (count > bytes.size()) {
+            throw invalid(path, "counts larger than the file");
+        }
+    }
+    const Layout layout = layoutOf(header);
+    if (layout.end != bytes.size()) {
+        throw invalid(path, "size " + std::to_string(bytes.size()) + " bytes, the header says "
+                            + std::to_string(layout.end));
+    }
+    ages_ = column<int>(bytes, layout.ages, header.rows);
+    nameIds_ = column<Id>(bytes, layout.nameIds, header.rows);
+    companyIds_ = column<Id>(bytes, layout.companyIds, header.rows);
+    nameOffsets_ = column<std::uint64_t>(bytes, layout.nameOffsets, header.names + 1);
+    companyOffsets_ = column<std::uint64_t>(bytes, layout.companyOffsets, header.companies + 1);
+    nameChars_ = bytes.substr(layout.nameChars, header.nameBytes);
+    companyChars_ = bytes.substr(layout.companyChars, header.companyBytes);
+    // Only the ends: the offsets in between are checked by verifyStrings(),
+    // and by text() for the strings that are actually looked up
+    for (auto [offsets, chars] : {std::pair(nameOffsets_, nameChars_), std::pair(companyOffsets_, companyChars_)}) {
+        if (offsets.front() != 0 || offsets.back() != chars.size()) {
+            throw invalid(path, "string offsets do not match the pool sizes");
+        }
+    }
+    columnBytes_ = bytes.substr(layout.ages, layout.nameOffsets - layout.ages);
+    columnChecksum_ = header.columnChecksum;
+    stringBytes_ = bytes.substr(layout.nameOffsets);
+    stringChecksum_ = header.stringChecksum;
+}
+
+std::string_view PersonSnapshot::text(std::span<const std::uint64_t> offsets, std::string_view chars, Id id) {
+    if (id >= offsets.size() - 1) {
+        throw std::runtime_error("person snapshot: string id " + std::to_string(id) + " out of range");
+    }
+    // Two comparisons instead of checking every offset on open
+    if (offsets[id] > offsets[id + 1] || offsets[id + 1] > chars.size()) {
+        throw std::runtime_error("person snapshot: string offsets out of order");
+    }
+    return chars.substr(offsets[id], offsets[id + 1] - offsets[id]);
+}
+
+std::string_view PersonSnapshot::company(std::size_t row) const {
+    Id id = companyIds_[row];
+    return id == PersonTable::kNoCompany ? std::string_view() : text(companyOffsets_, companyChars_, id);
+}
+
+std::size_t PersonSnapshot::countAtCompany(std::string_view company) const {
+    for (Id id = 0; id < companyCount(); id++) {
+        if (companyName(id) == company) {
+            return person_columns::countEqual(companyIds_, id);
+        }
+    }
+    return 0;
+}
+
+void PersonSnapshot::verifyColumns() const {
+    if (checksumOf(columnBytes_) != columnChecksum_) {
+        throw std::runtime_error("person snapshot: column checksum mismatch");
+    }
+}
+
+void PersonSnapshot::verifyStrings() const {
+    if (checksumOf(stringBytes_) != stringChecksum_) {
+        throw std::runtime_error("person snapshot: string pool checksum mismatch");
+    }
+    for (std::span<const std::uint64_t> offsets : {nameOffsets_, companyOffsets_}) {
+        if (!std::is_sorted(offsets.begin(), offsets.end())) {
+            throw std::runtime_error("person snapshot: string offsets out of order");
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.h"
+#include "person_table.h"
+
+/*
+ * A PersonTable saved as a binary file that opens without rebuilding it
+ * (similar to loading a memory-mapped index in C# instead of deserializing
+ * a List<Employee>, or to a database page file).
+ *
+ * The file is the table's columns, byte for byte, behind a fixed header:
+ *
+ *     header         magic "PTSNAP\0\0", version, byte order, row and
+ *                    string counts, three checksums
+ *     ages           int32[rows]
+ *     name ids       uint32[rows]
+ *     company ids    uint32[rows]       (PersonTable::kNoCompany for a Person)
+ *     name offsets   uint64[names + 1]  into the name characters
+ *     company offs.  uint64[companies + 1]
+ *     name chars, company chars
+ *
+ * Every section starts at a multiple of 64 bytes and the gaps are zero.
+ * Numbers are in the writer's byte order; a reader with the other byte
+ * order refuses the file.
+ *
+ * PersonSnapshot maps the file and points its spans straight into the
+ * mapping, so opening only checks the header and the file size, whatever
+ * the number of rows and strings. A page is only read when a query touches
+ * it. The checksums are therefore not checked on open: call verifyColumns()
+ * and verifyStrings() for that (one pass each at memory speed). Until then
+ * a damaged string offset is still caught when that string is looked up.
+ */
+inline constexpr std::uint32_t kSnapshotVersion = 1;
+
+// Writes to `path` + ".tmp" and renames it over `path`, so a reader never
+// sees half a file. Throws std::runtime_error if it cannot be written.
+void saveSnapshot(const PersonTable& table, const std::string& path);
+
+class PersonSnapshot {
+  public:
+      using Id = PersonTable::Id;
+
+      // Throws std::runtime_error if the file cannot be read or is not a
+      // valid snapshot (wrong magic, version or byte order, truncated,
+      // header checksum mismatch)
+      explicit PersonSnapshot(const std::string& path);
+
+      PersonSnapshot(PersonSnapshot&&) = default;
+      PersonSnapshot& operator=(PersonSnapshot&&) = default;
+
+      std::size_t size() const { return ages_.size(); }
+      bool mapped() const { return mapped_; }   // false: read into memory (no mmap here)
+
+      // ----- Rows (same values as the PersonTable that was saved) -----
+      std::string_view name(std::size_t row) const { return text(nameOffsets_, nameChars_, nameIds_[row]); }
+      int age(std::size_t row) const { return ages_[row]; }
+      bool isEmployee(std::size_t row) const { return companyIds_[row] != PersonTable::kNoCompany; }
+      std::string_view company(std::size_t row) const;   // Empty for a Person
+
+      // ----- Columns -----
+      std::span<const int> ages() const { return ages_; }
+      std::span<const Id> nameIds() const { return nameIds_; }
+      std::span<const Id> companyIds() const { return companyIds_; }
+      std::size_t nameCount() const { return nameOffsets_.size() - 1; }
+      std::size_t companyCount() const { return companyOffsets_.size() - 1; }
+      std::string_view companyName(Id id) const { return text(companyOffsets_, companyChars_, id); }
+
+      // ----- The PersonTable queries -----
+      double averageAge() const { return person_columns::averageAge(ages_); }
+      std::size_t countAtCompany(std::string_view company) const;
+      std::vector<std::size_t> countByCompany() const {
+          return person_columns::countById(companyIds_, companyCount());
+      }
+      std::size_t countInAgeRange(int minAge, int maxAge) const {
+          return person_columns::countInRange(ages_, minAge, maxAge);
+      }
+
+      // Reads every column and compares its checksum with the header's;
+      // throws std::runtime_error on a mismatch
+      void verifyColumns() const;
+      // The same for the string pools, and checks that every offset is in order
+      void verifyStrings() const;
+
+  private:
+      // Id `id` of a string pool; throws std::runtime_error for an id the
+      // pool does not have, or offsets out of order (only a damaged file
+      // can hold either)
+      static std::string_view text(std::span<const std::uint64_t> offsets, std::string_view chars, Id id);
+
+      std::optional<MappedFile> file_;
+      std::vector<std::uint64_t> buffer_;   // The file, where it cannot be mapped
+      bool mapped_ = false;
+      std::string_view columnBytes_;        // ages .. company ids, for verifyColumns()
+      std::uint64_t columnChecksum_ = 0;
+      std::string_view stringBytes_;        // Name offsets .. company chars, for verifyStrings()
+      std::uint64_t stringChecksum_ = 0;
+
+      std::span<const int> ages_;
+      std::span<const Id> nameIds_;
+      std::span<const Id> companyIds_;
+      std::span<const std::uint64_t> nameOffsets_;
+      std::span<const std::uint64_t> companyOffsets_;
+      std::string_view nameChars_;
+      std::string_view companyChars_;
+};
@@ -0,0 +1,103 @@
+#include "person_table.h"
+
+#include "output_sink.h"
+
+std::string_view PersonTable::Row::company() const {
+    Id id = table_->companyIds_[index_];
+    return id == kNoCompany ? std::string_view() : table_->companies_.view(id);
+}
+
+void PersonTable::Row::introduce() const {
+    if (isEmployee()) {
+        output() << "Hi, I'm " << name() << ", " << age()
+                 << " years old, and I work at " << company() << "." << '\n';
+    } else {
+        output() << "Hi, I'm " << name() << " and I'm " << age() << " years old." << '\n';
+    }
+}
+
+std::size_t PersonTable::addPerson(std::string_view name, int age) {
+    nameIds_.push_back(names_.intern(name));
+    ages_.push_back(age);
+    companyIds_.push_back(kNoCompany);
+    return ages_.size() - 1;
+}
+
+std::size_t PersonTable::addEmployee(std::string_view name, int age, std::string_view company) {
+    nameIds_.push_back(names_.intern(name));
+    ages_.push_back(age);
+    companyIds_.push_back(companies_.intern(company));
+    return ages_.size() - 1;
+}
+
+void PersonTable::reserve(std::size_t rows) {
+    ages_.reserve(rows);
+    nameIds_.reserve(rows);
+    companyIds_.reserve(rows);
+}
+
+double PersonTable::averageAge() const {
+    return person_columns::averageAge(ages_);
+}
+
+std::size_t PersonTable::countAtCompany(std::string_view company) const {
+    std::optional<Id> id = companies_.find(company);
+    return id ? person_columns::countEqual(companyIds_, *id) : 0;
+}
+
+std::vector<std::size_t> PersonTable::countByCompany() const {
+    return person_columns::countById(companyIds_, companies_.size());
+}
+
+std::size_t PersonTable::countInAgeRange(int minAge, int maxAge) const {
+    return person_columns::countInRange(ages_, minAge, maxAge);
+}
+
+// The loops below are written without branches in the body so that the
+// compiler can turn them into SIMD code
+namespace person_columns {
+
+double averageAge(std::span<const int> ages) {
+    if (ages.empty()) {
+        return 0;
+    }
+    long long total = 0;
+    for (int age : ages) {
+        total += age;
+    }
+    return static_cast<double>(total) / static_cast<double>(ages.size());
+}
+
+std::size_t countEqual(std::span<const StringPool::Id> ids, StringPool::Id wanted) {
+    std::size_t count = 0;
+    for (StringPool::Id id : ids) {
+        count += id == wanted;
+    }
+    return count;
+}
+
+std::vector<std::size_t> countById(std::span<const StringPool::Id> ids, std::size_t idCount) {
+    std::vector<std::size_t> counts(idCount, 0);
+    for (StringPool::Id id : ids) {
+        if (id < idCount) {   // Skips PersonTable::kNoCompany
+            counts[id]++;
+        }
+    }
+    return counts;
+}
+
+std::size_t countInRange(std::span<const int> ages, int minAge, int maxAge) {
+    if (maxAge < minAge) {
+        return 0;
+    }
+    // One unsigned comparison instead of two: age - minAge wraps around
+    // to a huge value when age < minAge
+    const unsigned width = static_cast<unsigned>(maxAge) - static_cast<unsigned>(minAge);
+    std::size_t count = 0;
+    for (int age : ages) {
+        count += (static_cast<unsigned>(age) - static_cast<unsigned>(minAge)) <= width;
+    }
+    return count;
+}
+
+}
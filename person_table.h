@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "string_pool.h"
+
+/*
+ * People stored column by column ("structure of arrays") instead of as a
+ * std::vector<Person> ("array of structures").
+ *
+ * Every age sits next to the other ages, and names and companies are
+ * interned 32-bit ids. A query that only looks at ages (average, range
+ * filter) therefore streams through 4 bytes per person instead of dragging
+ * whole Person objects, strings included, through the cache, and the
+ * simple loops over the columns can be auto-vectorized by the compiler.
+ */
+class PersonTable {
+  public:
+      using Id = StringPool::Id;
+      static constexpr Id kNoCompany = 0xFFFFFFFFu;   // Row is a Person, not an Employee
+
+      // A lightweight handle to one row that reads like a Person
+      class Row {
+        public:
+            Row(PersonTable& table, std::size_t index) : table_(&table), index_(index) {}
+
+            std::string_view name() const { return table_->names_.view(table_->nameIds_[index_]); }
+            int age() const { return table_->ages_[index_]; }
+            void setAge(int a) { table_->ages_[index_] = a; }
+            bool isEmployee() const { return table_->companyIds_[index_] != kNoCompany; }
+            std::string_view company() const;   // Empty for a Person
+
+            // Same text as Person::introduce / Employee::introduce
+            void introduce() const;
+
+        private:
+            PersonTable* table_;
+            std::size_t index_;
+      };
+
+      std::size_t addPerson(std::string_view name, int age);
+      std::size_t addEmployee(std::string_view name, int age, std::string_view company);
+
+      Row operator[](std::size_t index) { return Row(*this, index); }
+      std::size_t size() const { return ages_.size(); }
+      void reserve(std::size_t rows);
+
+      // ----- Columns -----
+      std::span<const int> ages() const { return ages_; }
+      std::span<const Id> nameIds() const { return nameIds_; }
+      std::span<const Id> companyIds() const { return companyIds_; }
+      const StringPool& names() const { return names_; }
+      const StringPool& companies() const { return companies_; }
+
+      // ----- Aggregate queries (one pass over one or two columns) -----
+      double averageAge() const;
+      std::size_t countAtCompany(std::string_view company) const;
+      // Rows per company, indexed by company id
+      std::vector<std::size_t> countByCompany() const;
+      // Rows with minAge <= age <= maxAge
+      std::size_t countInAgeRange(int minAge, int maxAge) const;
+
+  private:
+      std::vector<int> ages_;
+      std::vector<Id> nameIds_;
+      std::vector<Id> companyIds_;
+      StringPool names_;
+      StringPool companies_;
+};
+
+// The loops behind the aggregate queries, over bare columns (also used by
+// PersonSnapshot, whose columns live in a mapped file)
+namespace person_columns {
+
+double averageAge(std::span<const int> ages);
+std::size_t countEqual(std::span<const StringPool::Id> ids, StringPool::Id wanted);
+// counts[id] for every id < idCount; larger ids (kNoCompany) are skipped
+std::vector<std::size_t> countById(std::span<const StringPool::Id> ids, std::size_t idCount);
+std::size_t countInRange(std::span<const int> ages, int minAge, int maxAge);
+
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__cpp_lib_ranges) && !defined(MYPROJECT_NO_STD_RANGES)
+#include <ranges>
+#define MYPROJECT_PIPELINE_STD_RANGES 1
+#else
+#define MYPROJECT_PIPELINE_STD_RANGES 0
+#endif
+
+/*
+ * Lazy pipelines over a range (similar to LINQ in C#, or to chaining
+ * .map()/.filter()/.reduce() in JavaScript, but without the intermediate
+ * arrays that JavaScript builds at every step):
+ *
+ *     long long total = numbers | pipeline::transform([](int x) { return x * 2; })
+ *                               | pipeline::filter([](int x) { return x > 40; })
+ *                               | pipeline::sum<long long>();
+ *
+ * transform and filter only describe the work. Nothing runs until a
+ * terminal (sum, toVector, forEach) pulls the elements through, one at a
+ * time, in a single pass and without allocating.
+ *
+ * With C++20 ranges the stages are std::views::transform/filter. Otherwise a
+ * small hand-written equivalent below is used, with the same syntax.
+ */
+namespace pipeline {
+
+#if MYPROJECT_PIPELINE_STD_RANGES
+
+inline constexpr bool usesStdRanges = true;
+
+template <typename F>
+auto transform(F f) {
+    return std::views::transform(std::move(f));
+}
+
+template <typename P>
+auto filter(P predicate) {
+    return std::views::filter(std::move(predicate));
+}
+
+#else
+
+inline constexpr bool usesStdRanges = false;
+
+namespace detail {
+
+// Marks the lazy views below, which are cheap to copy
+struct ViewBase {};
+
+template <typename R>
+constexpr bool isView = std::is_base_of_v<ViewBase, std::remove_cvref_t<R>>;
+
+// A container taken by reference (the pipeline never copies the elements)
+template <typename R>
+class RefView : public ViewBase {
+  public:
+      explicit RefView(R& range) : range_(&range) {}
+      auto begin() const { return std::begin(*range_); }
+      auto end() const { return std::end(*range_); }
+
+  private:
+      R* range_;
+};
+
+template <typename R>
+auto asView(R&& range) {
+    if constexpr (isView<R>) {
+        return std::remove_cvref_t<R>(std::forward<R>(range));
+    } else {
+        static_assert(std::is_lvalue_reference_v<R>, "pipeline: a temporary container would dangle");
+        return RefView<std::remove_reference_t<R>>(range);
+    }
+}
+
+template <typename Base, typename F>
+class TransformView : public ViewBase {
+  public:
+      TransformView(Base base, F f) : base_(std::move(base)), f_(std::move(f)) {}
+
+      class iterator {
+        public:
+            using BaseIterator = decltype(std::declval<const Base&>().begin());
+
+            iterator(BaseIterator it, const F* f) : it_(it), f_(f) {}
+            decltype(auto) operator*() const { return std::invoke(*f_, *it_); }
+            iterator& operator++() {
+                ++it_;
+                return *this;
+            }
+            bool operator==(const iterator& other) const { return it_ == other.it_; }
+
+        private:
+            BaseIterator it_;
+            const F* f_;
+      };
+
+      iterator begin() const { return iterator(base_.begin(), &f_); }
+      iterator end() const { return iterator(base_.end(), &f_); }
+
+  private:
+      Base base_;
+      F f_;
+};
+
+template <typename Base, typename P>
+class FilterView : public ViewBase {
+  public:
+      FilterView(Base base, P predicate) : base_(std::move(base)), predicate_(std::move(predicate)) {}
+
+      class iterator {
+        public:
+            using BaseIterator = decltype(std::declval<const Base&>().begin());
+
+            iterator(BaseIterator it, BaseIterator end, const P* predicate)
+                : it_(it), end_(end), predicate_(predicate) {
+                skip();
+            }
+            decltype(auto) operator*() const { return *it_; }
+            iterator& operator++() {
+                ++it_;
+                skip();
+                return *this;
+            }
+            bool operator==(const iterator& other) const { return it_ == other.it_; }
+
+        private:
+            void skip() {
+                while (it_ != end_ && !std::invoke(*predicate_, *it_)) {
+                    ++it_;
+                }
+            }
+
+            BaseIterator it_;
+            BaseIterator end_;
+            const P* predicate_;
+      };
+
+      iterator begin() const { return iterator(base_.begin(), base_.end(), &predicate_); }
+      iterator end() const { return iterator(base_.end(), base_.end(), &predicate_); }
+
+  private:
+      Base base_;
+      P predicate_;
+};
+
+// What transform(f) and filter(p) return: a stage waiting for its input
+template <typename F>
+struct TransformStage {
+    F f;
+};
+
+template <typename P>
+struct FilterStage {
+    P predicate;
+};
+
+template <typename R, typename F>
+auto operator|(R&& range, TransformStage<F> stage) {
+    using Base = decltype(asView(std::forward<R>(range)));
+    return TransformView<Base, F>(asView(std::forward<R>(range)), std::move(stage.f));
+}
+
+template <typename R, typename P>
+auto operator|(R&& range, FilterStage<P> stage) {
+    using Base = decltype(asView(std::forward<R>(range)));
+    return FilterView<Base, P>(asView(std::forward<R>(range)), std::move(stage.predicate));
+}
+
+}
+
+template <typename F>
+detail::TransformStage<F> transform(F f) {
+    return {std::move(f)};
+}
+
+template <typename P>
+detail::FilterStage<P> filter(P predicate) {
+    return {std::move(predicate)};
+}
+
+#endif
+
+// ----- Terminals: these run the pipeline -----
+
+namespace detail {
+
+template <typename R>
+using ElementType = std::remove_cvref_t<decltype(*std::begin(std::declval<R&>()))>;
+
+// Result = void means "the element type"
+template <typename Result>
+struct SumTerminal {};
+
+struct ToVectorTerminal {};
+
+template <typename F>
+struct ForEachTerminal {
+    F f;
+};
+
+template <typename R, typename Result>
+auto operator|(R&& range, SumTerminal<Result>) {
+    using Total = std::conditional_t<std::is_void_v<Result>, ElementType<R>, Result>;
+    Total total{};
+    for (auto&& value : range) {
+        total += value;
+    }
+    return total;
+}
+
+template <typename R>
+auto operator|(R&& range, ToVectorTerminal) {
+    std::vector<ElementType<R>> values;
+    for (auto&& value : range) {
+        values.push_back(value);
+    }
+    return values;
+}
+
+template <typename R, typename F>
+void operator|(R&& range, ForEachTerminal<F> terminal) {
+    for (auto&& value : range) {
+        std::invoke(terminal.f, value);
+    }
+}
+
+}
+
+// Adds every element (in a wider type if given, e.g. sum<long long>())
+template <typename Result = void>
+detail::SumTerminal<Result> sum() {
+    return {};
+}
+
+// Materializes the elements (the one terminal that allocates)
+inline detail::ToVectorTerminal toVector() {
+    return {};
+}
+
+template <typename F>
+detail::ForEachTerminal<F> forEach(F f) {
+    return {std::move(f)};
+}
+
+}
@@ -0,0 +1,77 @@
+#include "section_registry.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include "instrumentation.h"
+#include "thread_pool.h"
+
+void SectionRegistry::add(std::string name, std::function<void()> run) {
+    sections_.push_back(Section{std::move(name), std::move(run), {}});
+}
+
+bool SectionRegistry::contains(std::string_view name) const {
+    return std::any_of(sections_.begin(), sections_.end(),
+                       [name](const Section& s) { return s.name == name; });
+}
+
+void SectionRegistry::select(const std::vector<std::string>& names) {
+    if (names.empty()) {
+        return;
+    }
+    for (const std::string& name : names) {
+        if (!contains(name)) {
+            throw std::invalid_argument("unknown section '" + name + "' (see --list)");
+        }
+    }
+    std::erase_if(sections_, [&names](const Section& s) {
+        return std::find(names.begin(), names.end(), s.name) == names.end();
+    });
+}
+
+SectionRunner::SectionRunner(OutputSink& sink, unsigned jobs)
+    : sink_(sink), jobs_(std::max(jobs, 1u)) {}
+
+void SectionRunner::run(std::vector<Section>& sections) {
+    if (jobs_ == 1 || sections.size() < 2) {
+        runSerial(sections);
+    } else {
+        runParallel(sections);
+    }
+}
+
+void SectionRunner::runSerial(std::vector<Section>& sections) {
+    ScopedOutput redirect(sink_.stream());
+    for (Section& section : sections) {
+        {
+            instrumentation::SectionScope scope(section.name);
+            section.run();
+        }
+        sink_.flush();
+    }
+}
+
+void SectionRunner::runParallel(std::vector<Section>& sections) {
+    ThreadPool pool(std::min<std::size_t>(jobs_, sections.size()));
+    std::vector<PoolTask<void>> done;
+    done.reserve(sections.size());
+    for (Section& section : sections) {
+        done.push_back(pool.submit([&section] {
+            std::ostringstream buffer;
+            ScopedOutput redirect(buffer);
+            {
+                instrumentation::SectionScope scope(section.name);
+                section.run();
+            }
+            section.output = std::move(buffer).str();
+        }));
+    }
+
+    // Emit in canonical order while later sections are still running
+    for (std::size_t i = 0; i < sections.size(); i++) {
+        done[i].get();  // Rethrows anything the section threw
+        sink_.stream() << sections[i].output;
+        sink_.flush();
+    }
+}
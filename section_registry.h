@@ -0,0 +1,57 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "output_sink.h"
+
+// One tutorial section: its name (for --only), the function that prints it
+// and the buffer its output is captured into when sections run in parallel
+struct Section {
+    std::string name;
+    std::function<void()> run;
+    std::string output;
+};
+
+// The sections in their canonical (printing) order
+class SectionRegistry {
+  public:
+      void add(std::string name, std::function<void()> run);
+
+      bool contains(std::string_view name) const;
+
+      // Keeps only the named sections, still in canonical order.
+      // An empty list keeps everything. Throws std::invalid_argument
+      // for names that are not registered.
+      void select(const std::vector<std::string>& names);
+
+      std::vector<Section>& sections() { return sections_; }
+      const std::vector<Section>& sections() const { return sections_; }
+
+  private:
+      std::vector<Section> sections_;
+};
+
+/*
+ * Runs sections and writes their output to the sink in canonical order.
+ *
+ * With one job every section writes straight into the sink. With more jobs
+ * the sections run on a thread pool, each into its own buffer, and the
+ * buffers are emitted in registry order as soon as they are ready, so the
+ * output is byte-identical to a serial run.
+ */
+class SectionRunner {
+  public:
+      SectionRunner(OutputSink& sink, unsigned jobs);
+
+      void run(std::vector<Section>& sections);
+
+  private:
+      void runSerial(std::vector<Section>& sections);
+      void runParallel(std::vector<Section>& sections);
+
+      OutputSink& sink_;
+      unsigned jobs_;
+};
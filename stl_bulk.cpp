@@ -0,0 +1,129 @@
+#include "stl_bulk.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "kernels.h"
+#include "parallel_stl.h"
+
+namespace {
+
+// Milliseconds taken by body()
+template <typename F>
+double timeMs(F&& body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+void printTiming(std::ostream& out, const char* what, double stlMs, double kernelMs) {
+    out << "   " << what << ": std " << stlMs << " ms, kernel " << kernelMs << " ms";
+    if (kernelMs > 0) {
+        out << " (" << stlMs / kernelMs << "x)";
+    }
+    out << '\n';
+}
+
+void printSpeedup(std::ostream& out, const char* what, double stlMs, double parallelMs) {
+    out << what << " " << parallelMs << " ms";
+    if (parallelMs > 0) {
+        out << " (" << stlMs / parallelMs << "x)";
+    }
+}
+
+void check(bool ok, const char* what) {
+    if (!ok) {
+        throw std::runtime_error(std::string(what) + " result differs from the STL");
+    }
+}
+
+}
+
+void runBulkStl(std::ostream& out, const StlOptions& options) {
+    const std::size_t n = options.bulkSize;
+    out << "Bulk algorithms over " << n << " ints (kernels: "
+        << kernels::isaName(kernels::bestIsa()) << ")" << '\n';
+
+    // A fixed seed, so every run sorts the same numbers
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::int32_t> anyInt(-1'000'000'000, 1'000'000'000);
+    std::vector<std::int32_t> numbers(n);
+    for (std::int32_t& value : numbers) {
+        value = anyInt(random);
+    }
+
+    // Transform: the same doubling lambda as above. The kernel wraps around
+    // on overflow, so make the STL version do the same for the comparison.
+    std::vector<std::int32_t> expected(n);
+    std::vector<std::int32_t> actual(n);
+    const double transformMs = timeMs([&] {
+        std::transform(numbers.begin(), numbers.end(), expected.begin(), [](std::int32_t x) {
+            return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) * 2u);
+        });
+    });
+    double kernelMs = timeMs([&] { kernels::doubleValues(numbers, actual); });
+    check(expected == actual, "transform");
+    printTiming(out, "transform", transformMs, kernelMs);
+
+    // Find: look for the last element, so both scan (almost) everything
+    std::int32_t needle = n > 0 ? numbers.back() : 0;
+    std::size_t stlPosition = 0;
+    std::size_t kernelPosition = 0;
+    const double findMs = timeMs([&] {
+        stlPosition = static_cast<std::size_t>(std::find(numbers.begin(), numbers.end(), needle) - numbers.begin());
+    });
+    kernelMs = timeMs([&] { kernelPosition = kernels::findValue(numbers, needle); });
+    check(stlPosition == kernelPosition, "find");
+    printTiming(out, "find", findMs, kernelMs);
+
+    // Sort: both start from the same unsorted copy
+    expected = numbers;
+    actual = numbers;
+    const double sortMs = timeMs([&] { std::sort(expected.begin(), expected.end()); });
+    kernelMs = timeMs([&] { kernels::sortValues(actual); });
+    check(expected == actual, "sort");
+    printTiming(out, "sort", sortMs, kernelMs);
+
+    if (options.policy == parallel::Policy::Seq) {
+        return;
+    }
+
+    // The same three with an execution policy, on 1, 2, 4, ... threads up
+    // to every hardware thread. Speedups are over the sequential std:: runs.
+    out << "Policy " << parallel::policyName(options.policy) << " ("
+        << (parallel::usesStandardPolicies() ? "std::execution" : "thread pool fallback")
+        << "), speedup over sequential std::" << '\n';
+    const std::vector<std::int32_t> sorted = std::move(expected);
+    std::vector<std::int32_t> doubled(n);
+    std::transform(numbers.begin(), numbers.end(), doubled.begin(), [](std::int32_t x) {
+        return static_cast<std::int32_t>(static_cast<std::uint32_t>(x) * 2u);
+    });
+    const unsigned maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        parallel::ParallelAlgorithms algorithms(options.policy, threads);
+        double parallelTransformMs = timeMs([&] { algorithms.doubleValues(numbers, actual); });
+        check(actual == doubled, "parallel transform");
+        std::size_t position = 0;
+        double parallelFindMs = timeMs([&] { position = algorithms.findValue(numbers, needle); });
+        check(position == stlPosition, "parallel find");
+        actual = numbers;
+        double parallelSortMs = timeMs([&] { algorithms.sortValues(actual); });
+        check(actual == sorted, "parallel sort");
+
+        out << "   " << threads << (threads == 1 ? " thread:  " : " threads: ");
+        printSpeedup(out, "transform", transformMs, parallelTransformMs);
+        printSpeedup(out, ", find", findMs, parallelFindMs);
+        printSpeedup(out, ", sort", sortMs, parallelSortMs);
+        out << '\n';
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <ostream>
+
+#include "options.h"
+
+// The find/sort/transform examples of demonstrateStl over options.bulkSize
+// random ints: each one with the std:: algorithm and with the matching
+// kernel from kernels.h, timed, and checked for identical results. With a
+// parallel options.policy they are timed again on 1 to all hardware threads.
+// Throws std::runtime_error if a result differs from the STL.
+void runBulkStl(std::ostream& out, const StlOptions& options);
@@ -0,0 +1,80 @@
+#include "string_pool.h"
+
+#include <stdexcept>
+
+// FNV-1a: simple and good enough for short names
+std::uint64_t StringPool::hash(std::string_view text) {
+    std::uint64_t h = 14695981039346656037ull;
+    for (char c : text) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// The slot holding `text`, or the empty slot where it would go
+std::size_t StringPool::findSlot(std::string_view text, std::uint64_t h) const {
+    const std::size_t mask = slots_.size() - 1;
+    std::size_t slot = static_cast<std::size_t>(h) & mask;
+    for (;;) {
+        Id entry = slots_[slot];
+        if (entry == 0) {
+            return slot;
+        }
+        Id id = entry - 1;
+        if (hashes_[id] == h && view(id) == text) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+void StringPool::grow() {
+    std::size_t capacity = slots_.empty() ? 64 : slots_.size() * 2;
+    slots_.assign(capacity, 0);
+    const std::size_t mask = capacity - 1;
+    for (Id id = 0; id < size(); id++) {
+        std::size_t slot = static_cast<std::size_t>(hashes_[id]) & mask;
+        while (slots_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = id + 1;
+    }
+}
+
+StringPool::Id StringPool::intern(std::string_view text) {
+    // Keep the index at most half full so probe runs stay short
+    if ((size() + 1) * 2 > slots_.size()) {
+        grow();
+    }
+    std::uint64_t h = hash(text);
+    std::size_t slot = findSlot(text, h);
+    if (slots_[slot] != 0) {
+        return slots_[slot] - 1;
+    }
+    if (size() >= 0xFFFFFFFEu) {
+        throw std::length_error("StringPool: too many strings for 32-bit ids");
+    }
+    Id id = static_cast<Id>(size());
+    chars_.insert(chars_.end(), text.begin(), text.end());
+    offsets_.push_back(chars_.size());
+    hashes_.push_back(h);
+    slots_[slot] = id + 1;
+    return id;
+}
+
+std::optional<StringPool::Id> StringPool::find(std::string_view text) const {
+    if (slots_.empty()) {
+        return std::nullopt;
+    }
+    std::size_t slot = findSlot(text, hash(text));
+    if (slots_[slot] == 0) {
+        return std::nullopt;
+    }
+    return slots_[slot] - 1;
+}
+
+std::size_t StringPool::memoryUsage() const {
+    return chars_.capacity() + offsets_.capacity() * sizeof(std::uint64_t)
+         + slots_.capacity() * sizeof(Id) + hashes_.capacity() * sizeof(std::uint64_t);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+/*
+ * A deduplicating string table ("interning"): every distinct string is
+ * stored once, back to back in one character buffer, and is referred to by
+ * a 32-bit id (similar to string.Intern in C#, but with ids instead of
+ * references). Ids are dense, 0, 1, 2, ... in insertion order.
+ *
+ * Views returned by view() stay valid until the next intern() call, which
+ * may grow the buffer.
+ */
+class StringPool {
+  public:
+      using Id = std::uint32_t;
+
+      // Returns the id of `text`, adding it if it is new
+      Id intern(std::string_view text);
+
+      // The id of `text` if it has been interned
+      std::optional<Id> find(std::string_view text) const;
+
+      std::string_view view(Id id) const {
+          return {chars_.data() + offsets_[id], static_cast<std::size_t>(offsets_[id + 1] - offsets_[id])};
+      }
+
+      std::size_t size() const { return offsets_.size() - 1; }
+
+      // Raw layout: all characters, and size() + 1 offsets into them
+      const std::vector<char>& characters() const { return chars_; }
+      const std::vector<std::uint64_t>& offsets() const { return offsets_; }
+
+      // Bytes held by the pool (characters, offsets and the hash index)
+      std::size_t memoryUsage() const;
+
+  private:
+      static std::uint64_t hash(std::string_view text);
+      std::size_t findSlot(std::string_view text, std::uint64_t h) const;
+      void grow();
+
+      std::vector<char> chars_;
+      std::vector<std::uint64_t> offsets_{0};
+      // Open addressing index: slot holds id + 1, 0 means empty
+      std::vector<Id> slots_;
+      std::vector<std::uint64_t> hashes_;  // Hash of each id, so growing does not rehash text
+};
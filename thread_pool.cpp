@@ -0,0 +1,389 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "instrumentation.h"
+
+#if defined(__linux__) && __has_include(<pthread.h>) && __has_include(<sched.h>)
+#include <pthread.h>
+#include <sched.h>
+#define MYPROJECT_HAS_AFFINITY 1
+#else
+#define MYPROJECT_HAS_AFFINITY 0
+#endif
+
+using thread_pool_detail::Job;
+
+namespace {
+
+/*
+ * The Chase-Lev deque ("Dynamic Circular Work-Stealing Deque", 2005) with
+ * the memory orders of Lê et al., "Correct and Efficient Work-Stealing for
+ * Weak Memory Models" (2013). Only the owning worker pushes and pops, at
+ * the bottom; any thread may steal from the top. The ring doubles when it
+ * is full. Outgrown rings stay allocated until the deque is destroyed,
+ * because a thief may still be reading from one.
+ */
+class WorkDeque {
+  public:
+      WorkDeque() {
+          rings_.push_back(std::make_unique<Ring>(kInitialCapacity));
+          ring_.store(rings_.back().get(), std::memory_order_relaxed);
+      }
+
+      // Owner only
+      void push(Job* job) {
+          std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+          std::int64_t top = top_.load(std::memory_order_acquire);
+          Ring* ring = ring_.load(std::memory_order_relaxed);
+          if (bottom - top > static_cast<std::int64_t>(ring->mask)) {
+              ring = grow(ring, top, bottom);
+          }
+          ring->put(bottom, job);
+          std::atomic_thread_fence(std::memory_order_release);
+          bottom_.store(bottom + 1, std::memory_order_relaxed);
+      }
+
+      // Owner only: the newest job, or nullptr
+      Job* pop() {
+          std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+          Ring* ring = ring_.load(std::memory_order_relaxed);
+          bottom_.store(bottom, std::memory_order_relaxed);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          std::int64_t top = top_.load(std::memory_order_relaxed);
+          if (top > bottom) {
+              bottom_.store(bottom + 1, std::memory_order_relaxed);
+              return nullptr;
+          }
+          Job* job = ring->get(bottom);
+          if (top == bottom) {
+              // The last one: race the thieves for it
+              if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                std::memory_order_relaxed)) {
+                  job = nullptr;
+              }
+              bottom_.store(bottom + 1, std::memory_order_relaxed);
+          }
+          return job;
+      }
+
+      // Any thread: the oldest job, or nullptr. Sets `contended` when
+      // another thread took the job first (so the deque may not be empty).
+      Job* steal(bool& contended) {
+          std::int64_t top = top_.load(std::memory_order_acquire);
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+          if (top >= bottom) {
+              return nullptr;
+          }
+          Job* job = ring_.load(std::memory_order_acquire)->get(top);
+          if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed)) {
+              contended = true;
+              return nullptr;
+          }
+          return job;
+      }
+
+  private:
+      static constexpr std::size_t kInitialCapacity = 256;
+
+      struct Ring {
+          explicit Ring(std::size_t capacity)
+              : mask(capacity - 1), slots(new std::atomic<Job*>[capacity]) {}
+
+          // Release/acquire on the slot as well, so the job's contents are
+          // visible to a thief even to tools that do not model the fences
+          Job* get(std::int64_t i) const {
+              return slots[static_cast<std::size_t>(i) & mask].load(std::memory_order_acquire);
+          }
+          void put(std::int64_t i, Job* job) {
+              slots[static_cast<std::size_t>(i) & mask].store(job, std::memory_order_release);
+          }
+
+          std::size_t mask;
+          std::unique_ptr<std::atomic<Job*>[]> slots;
+      };
+
+      Ring* grow(Ring* ring, std::int64_t top, std::int64_t bottom) {
+          auto bigger = std::make_unique<Ring>(2 * (ring->mask + 1));
+          for (std::int64_t i = top; i < bottom; i++) {
+              bigger->put(i, ring->get(i));
+          }
+          rings_.push_back(std::move(bigger));
+          ring = rings_.back().get();
+          ring_.store(ring, std::memory_order_release);
+          return ring;
+      }
+
+      alignas(64) std::atomic<std::int64_t> top_{0};      // Thieves
+      alignas(64) std::atomic<std::int64_t> bottom_{0};   // Owner
+      std::atomic<Ring*> ring_;
+      std::vector<std::unique_ptr<Ring>> rings_;          // Owner only
+};
+
+// Idle rounds (scan, yield) before a worker goes to sleep
+constexpr int kSpinRounds = 32;
+
+void runJob(Job* job) {
+    instrumentation::TaskScope scope;
+    std::unique_ptr<Job> owned(job);
+    owned->run();
+}
+
+#if MYPROJECT_HAS_AFFINITY
+
+// "0-3,8,10-11" (the sysfs cpulist format)
+std::vector<int> parseCpuList(std::string_view text) {
+    std::vector<int> cpus;
+    while (!text.empty()) {
+        std::string_view range = text.substr(0, text.find(','));
+        text.remove_prefix(std::min(text.size(), range.size() + 1));
+        int first = 0;
+        int last = 0;
+        auto [end, ec] = std::from_chars(range.data(), range.data() + range.size(), first);
+        if (ec != std::errc()) {
+            break;
+        }
+        last = first;
+        if (end != range.data() + range.size() && *end == '-') {
+            std::from_chars(end + 1, range.data() + range.size(), last);
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+// The CPUs of each NUMA node this process may run on, empty nodes left out
+std::vector<std::vector<int>> numaNodes(const std::vector<int>& allowed) {
+    std::vector<std::vector<int>> nodes;
+    std::error_code error;
+    const std::filesystem::path root = "/sys/devices/system/node";
+    for (int node = 0; std::filesystem::exists(root / ("node" + std::to_string(node)), error); node++) {
+        std::ifstream file(root / ("node" + std::to_string(node)) / "cpulist");
+        std::string text;
+        std::getline(file, text);
+        std::vector<int> cpus = parseCpuList(text);
+        std::erase_if(cpus, [&](int cpu) { return std::find(allowed.begin(), allowed.end(), cpu) == allowed.end(); });
+        if (!cpus.empty()) {
+            nodes.push_back(std::move(cpus));
+        }
+    }
+    return nodes;
+}
+
+// The CPUs each worker should stay on (an empty list: anywhere)
+std::vector<std::vector<int>> placeWorkers(Pinning pinning, std::size_t workers) {
+    std::vector<std::vector<int>> placement(workers);
+    const std::vector<int> allowed = allowedCpus();
+    if (pinning == Pinning::None || allowed.empty()) {
+        return placement;
+    }
+    std::vector<std::vector<int>> groups;
+    if (pinning == Pinning::NumaNodes) {
+        groups = numaNodes(allowed);
+    }
+    if (groups.empty()) {   // Pinning::Cores, or no NUMA information: one group per CPU
+        for (int cpu : allowed) {
+            groups.push_back({cpu});
+        }
+    }
+    for (std::size_t i = 0; i < workers; i++) {
+        placement[i] = groups[i % groups.size()];
+    }
+    return placement;
+}
+
+bool pinCurrentThread(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+#else
+
+std::vector<std::vector<int>> placeWorkers(Pinning, std::size_t workers) {
+    return std::vector<std::vector<int>>(workers);
+}
+
+bool pinCurrentThread(const std::vector<int>&) {
+    return false;
+}
+
+#endif
+
+}
+
+struct ThreadPool::Worker {
+    ThreadPool* pool = nullptr;
+    std::size_t index = 0;
+    WorkDeque deque;
+    std::uint32_t random = 0;   // xorshift state for picking a victim
+    std::thread thread;
+};
+
+namespace {
+
+thread_local ThreadPool::Worker* tlsWorker = nullptr;
+
+}
+
+ThreadPool::ThreadPool(std::size_t threadCount, Pinning pinning) {
+    threadCount = std::max<std::size_t>(threadCount, 1);
+    const std::vector<std::vector<int>> placement = placeWorkers(pinning, threadCount);
+    workers_.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->pool = this;
+        worker->index = i;
+        worker->random = static_cast<std::uint32_t>(i) * 2654435761u + 1;
+        workers_.push_back(std::move(worker));
+    }
+    // Only start once every deque exists: the workers steal from each other
+    for (std::size_t i = 0; i < threadCount; i++) {
+        Worker& worker = *workers_[i];
+        worker.thread = std::thread([this, &worker, cpus = placement[i]] {
+            tlsWorker = &worker;
+            instrumentation::nameThread("worker " + std::to_string(worker.index));
+            if (!cpus.empty() && pinCurrentThread(cpus)) {
+                pinned_.fetch_add(1);
+            }
+            workerLoop(worker);
+            tlsWorker = nullptr;
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    stopping_.store(true);
+    epoch_.fetch_add(1);
+    epoch_.notify_all();
+    for (std::unique_ptr<Worker>& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+ThreadPool::Worker* ThreadPool::currentWorker() const {
+    return tlsWorker && tlsWorker->pool == this ? tlsWorker : nullptr;
+}
+
+void ThreadPool::enqueue(Job* job) {
+    if (Worker* self = currentWorker()) {
+        self->deque.push(job);
+    } else {
+        std::lock_guard<std::mutex> lock(sharedMutex_);
+        shared_.push_back(job);
+        sharedCount_.fetch_add(1);
+    }
+    // A sleeper either sees the new epoch before it sleeps, or it counted
+    // itself in sleepers_ before we look (both seq_cst), so nobody misses
+    // a task. Without sleepers, no system call.
+    epoch_.fetch_add(1);
+    if (sleepers_.load() > 0) {
+        epoch_.notify_one();
+    }
+}
+
+Job* ThreadPool::findWork(Worker& self) {
+    if (Job* job = self.deque.pop()) {
+        return job;
+    }
+    if (sharedCount_.load() > 0) {
+        std::lock_guard<std::mutex> lock(sharedMutex_);
+        if (!shared_.empty()) {
+            Job* job = shared_.front();
+            shared_.pop_front();
+            sharedCount_.fetch_sub(1);
+            return job;
+        }
+    }
+    const std::size_t count = workers_.size();
+    if (count == 1) {
+        return nullptr;
+    }
+    // Try every other worker once, starting at a random one; go round
+    // again while a steal lost a race, since that deque was not empty
+    for (;;) {
+        self.random ^= self.random << 13;
+        self.random ^= self.random >> 17;
+        self.random ^= self.random << 5;
+        const std::size_t start = self.random % count;
+        bool contended = false;
+        for (std::size_t i = 0; i < count; i++) {
+            Worker& victim = *workers_[(start + i) % count];
+            if (&victim == &self) {
+                continue;
+            }
+            if (Job* job = victim.deque.steal(contended)) {
+                return job;
+            }
+        }
+        if (!contended) {
+            return nullptr;
+        }
+    }
+}
+
+void ThreadPool::workerLoop(Worker& self) {
+    int idleRounds = 0;
+    for (;;) {
+        const std::uint32_t seen = epoch_.load();
+        if (Job* job = findWork(self)) {
+            runJob(job);
+            idleRounds = 0;
+            continue;
+        }
+        // Nothing anywhere. New tasks can now only come from tasks still
+        // running on other workers, which keep those on their own deques.
+        if (stopping_.load()) {
+            return;
+        }
+        if (++idleRounds < kSpinRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+        sleepers_.fetch_add(1);
+        epoch_.wait(seen);
+        sleepers_.fetch_sub(1);
+        idleRounds = 0;
+    }
+}
+
+void ThreadPool::waitUntil(const std::atomic<bool>& done) {
+    Worker* self = currentWorker();
+    while (!done.load(std::memory_order_acquire)) {
+        if (self) {
+            if (Job* job = findWork(*self)) {
+                runJob(job);
+                continue;
+            }
+        }
+        // The task is running somewhere (or waits for one that is)
+        done.wait(false, std::memory_order_acquire);
+    }
+}
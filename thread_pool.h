@@ -0,0 +1,261 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * A fixed-size pool of worker threads with work stealing (similar to the
+ * .NET ThreadPool, whose workers also keep local queues and steal from each
+ * other, or to a pool of Node.js worker_threads). Tasks are queued with
+ * submit() and the result (or exception) comes back through a PoolTask,
+ * like a C# Task<T>: get() waits for it and then() chains a continuation,
+ * like ContinueWith or a JavaScript promise's .then().
+ *
+ * Every worker owns a Chase-Lev deque. A task submitted from inside a
+ * worker goes onto that worker's deque, which the worker pops from the
+ * bottom (newest first, while its data is still in cache) and idle workers
+ * steal from at the top (oldest first, usually the biggest piece of work
+ * left). Tasks submitted from any other thread go onto a shared queue.
+ * get() called from a worker runs other tasks while it waits, so a task may
+ * submit subtasks and wait for them (fork/join) without tying up a thread.
+ */
+
+// Where the workers run
+enum class Pinning {
+    None,        // Wherever the operating system puts them
+    Cores,       // Worker i on the i-th CPU this process may use
+    NumaNodes,   // Worker i on the CPUs of NUMA node i % (number of nodes)
+};
+
+class ThreadPool;
+
+template <typename T>
+class PoolTask;
+
+namespace thread_pool_detail {
+
+// A queued unit of work. run() must not throw.
+struct Job {
+    virtual ~Job() = default;
+    virtual void run() = 0;
+};
+
+template <typename F>
+struct FunctionJob final : Job {
+    explicit FunctionJob(F f) : function(std::move(f)) {}
+    void run() override { function(); }
+    F function;
+};
+
+template <typename F>
+Job* makeJob(F function) {
+    return new FunctionJob<F>(std::move(function));
+}
+
+// The result of a task: the value, or nothing for void
+template <typename T>
+struct Result {
+    std::optional<T> value;
+
+    template <typename F>
+    void set(F& function) { value.emplace(function()); }
+    T take() { return std::move(*value); }
+    template <typename F>
+    decltype(auto) passTo(F& function) { return function(std::move(*value)); }
+};
+
+template <>
+struct Result<void> {
+    template <typename F>
+    void set(F& function) { function(); }
+    void take() {}
+    template <typename F>
+    decltype(auto) passTo(F& function) { return function(); }
+};
+
+// What a PoolTask shares with the job that produces its result
+template <typename T>
+struct TaskState {
+    explicit TaskState(ThreadPool& owner) : pool(owner) {}
+
+    // Runs function, stores what it returns or throws, then completes
+    template <typename F>
+    void run(F& function);
+    void fail(std::exception_ptr error);
+    // Queues job once this task has completed (at once if it already has)
+    void attach(Job* job);
+
+    ThreadPool& pool;
+    std::atomic<bool> done{false};
+    Result<T> result;
+    std::exception_ptr exception;
+    std::mutex mutex;                    // Orders attach() against completion
+    std::unique_ptr<Job> continuation;
+
+  private:
+    void complete();
+};
+
+template <typename T, typename F>
+using ContinuationResult = std::conditional_t<std::is_void_v<T>, std::invoke_result<F>, std::invoke_result<F, T>>;
+
+}
+
+class ThreadPool {
+  public:
+      explicit ThreadPool(std::size_t threadCount, Pinning pinning = Pinning::None);
+      ~ThreadPool();  // Runs every queued task (and what those submit), then joins the workers
+
+      ThreadPool(const ThreadPool&) = delete;
+      ThreadPool& operator=(const ThreadPool&) = delete;
+
+      template <typename F>
+      auto submit(F task) -> PoolTask<std::invoke_result_t<F>> {
+          using Result = std::invoke_result_t<F>;
+          auto state = std::make_shared<thread_pool_detail::TaskState<Result>>(*this);
+          enqueue(thread_pool_detail::makeJob([state, task = std::move(task)]() mutable {
+              state->run(task);
+          }));
+          return PoolTask<Result>(std::move(state));
+      }
+
+      std::size_t size() const { return workers_.size(); }
+
+      // The workers that could be pinned as asked (0 without Pinning or
+      // where the system does not support it)
+      std::size_t pinnedWorkers() const { return pinned_.load(); }
+
+      struct Worker;   // A thread and its deque (thread_pool.cpp)
+
+  private:
+      template <typename>
+      friend struct thread_pool_detail::TaskState;
+      template <typename>
+      friend class PoolTask;
+
+      void enqueue(thread_pool_detail::Job* job);
+      // Returns once done is true. On a worker of this pool, runs other
+      // tasks in the meantime.
+      void waitUntil(const std::atomic<bool>& done);
+
+      Worker* currentWorker() const;
+      thread_pool_detail::Job* findWork(Worker& self);
+      void workerLoop(Worker& self);
+
+      std::vector<std::unique_ptr<Worker>> workers_;
+      std::mutex sharedMutex_;
+      std::deque<thread_pool_detail::Job*> shared_;          // Submitted from outside the pool
+      std::atomic<std::size_t> sharedCount_{0};
+      std::atomic<std::uint32_t> epoch_{0};                  // Bumped for every new task
+      std::atomic<std::uint32_t> sleepers_{0};
+      std::atomic<bool> stopping_{false};
+      std::atomic<std::size_t> pinned_{0};
+};
+
+// The result of a task on a ThreadPool (similar to a C# Task<T>)
+template <typename T>
+class PoolTask {
+  public:
+      PoolTask() = default;
+
+      bool valid() const { return state_ != nullptr; }
+      bool ready() const { return state_->done.load(std::memory_order_acquire); }
+
+      // Waits for the task, then returns its result or rethrows what it
+      // threw. Like std::future::get, it can only be called once.
+      T get() {
+          std::shared_ptr<State> state = std::move(state_);
+          state->pool.waitUntil(state->done);
+          if (state->exception) {
+              std::rethrow_exception(state->exception);
+          }
+          return state->result.take();
+      }
+
+      // Runs continuation(result) on the pool once this task is done and
+      // returns its task; consumes this one. If this task threw, the
+      // continuation is skipped and its task rethrows the same exception.
+      template <typename F>
+      auto then(F continuation) && -> PoolTask<typename thread_pool_detail::ContinuationResult<T, F>::type> {
+          using Next = typename thread_pool_detail::ContinuationResult<T, F>::type;
+          std::shared_ptr<State> previous = std::move(state_);
+          auto next = std::make_shared<thread_pool_detail::TaskState<Next>>(previous->pool);
+          State& antecedent = *previous;
+          antecedent.attach(thread_pool_detail::makeJob(
+              [previous = std::move(previous), next, continuation = std::move(continuation)]() mutable {
+                  if (previous->exception) {
+                      next->fail(previous->exception);
+                      return;
+                  }
+                  auto body = [&] { return previous->result.passTo(continuation); };
+                  next->run(body);
+              }));
+          return PoolTask<Next>(std::move(next));
+      }
+
+  private:
+      friend class ThreadPool;
+      template <typename>
+      friend class PoolTask;
+      using State = thread_pool_detail::TaskState<T>;
+
+      explicit PoolTask(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+      std::shared_ptr<State> state_;
+};
+
+namespace thread_pool_detail {
+
+template <typename T>
+template <typename F>
+void TaskState<T>::run(F& function) {
+    try {
+        result.set(function);
+    } catch (...) {
+        exception = std::current_exception();
+    }
+    complete();
+}
+
+template <typename T>
+void TaskState<T>::fail(std::exception_ptr error) {
+    exception = std::move(error);
+    complete();
+}
+
+template <typename T>
+void TaskState<T>::attach(Job* job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!done.load(std::memory_order_relaxed)) {
+            continuation.reset(job);
+            return;
+        }
+    }
+    pool.enqueue(job);
+}
+
+template <typename T>
+void TaskState<T>::complete() {
+    std::unique_ptr<Job> next;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.store(true, std::memory_order_release);
+        next = std::move(continuation);
+    }
+    done.notify_all();
+    if (next) {
+        pool.enqueue(next.release());
+    }
+}
+
+}
@@ -0,0 +1,646 @@
+#include "utf.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define UTF_X86 1
+#include <immintrin.h>
+#else
+#define UTF_X86 0
+#endif
+
+namespace utf {
+
+namespace {
+
+using kernels::Isa;
+
+enum class OnError { Throw, Replace };
+
+constexpr char32_t kReplacement = 0xFFFD;
+
+// Characters decoded or encoded one at a time before the next try at a
+// whole block of ASCII with the vector code
+constexpr std::size_t kBlock = 32;
+
+bool isContinuation(unsigned char byte) {
+    return (byte & 0xC0) == 0x80;
+}
+
+bool isHighSurrogate(char32_t c) {
+    return c >= 0xD800 && c <= 0xDBFF;
+}
+
+bool isLowSurrogate(char32_t c) {
+    return c >= 0xDC00 && c <= 0xDFFF;
+}
+
+// Not a surrogate and not past U+10FFFF
+bool isScalarValue(char32_t c) {
+    return c < 0xD800 || (c > 0xDFFF && c <= 0x10FFFF);
+}
+
+template <typename Unit>
+char32_t codePointOf(Unit unit) {
+    // wchar_t is signed on Linux
+    return static_cast<char32_t>(static_cast<std::make_unsigned_t<Unit>>(unit));
+}
+
+void requireSupported(Isa isa) {
+    if (!kernels::isSupported(isa)) {
+        throw std::invalid_argument(std::string("instruction set not supported here: ") + kernels::isaName(isa));
+    }
+}
+
+// ----- Scalar UTF-8 (also used around every vector loop) -----
+
+// Length of the valid sequence starting at s[0], or 0 if it is invalid
+std::size_t sequenceLength(const unsigned char* s, std::size_t remaining) {
+    const unsigned char lead = s[0];
+    if (lead < 0x80) {
+        return 1;
+    }
+    if (lead < 0xC2) {   // A continuation byte, or an overlong two-byte sequence
+        return 0;
+    }
+    if (lead < 0xE0) {
+        return remaining >= 2 && isContinuation(s[1]) ? 2 : 0;
+    }
+    if (lead < 0xF0) {
+        if (remaining < 3 || !isContinuation(s[1]) || !isContinuation(s[2])) {
+            return 0;
+        }
+        // Overlong, or a surrogate (U+D800..U+DFFF)
+        return (lead == 0xE0 && s[1] < 0xA0) || (lead == 0xED && s[1] >= 0xA0) ? 0 : 3;
+    }
+    if (lead < 0xF5) {
+        if (remaining < 4 || !isContinuation(s[1]) || !isContinuation(s[2]) || !isContinuation(s[3])) {
+            return 0;
+        }
+        // Overlong, or past U+10FFFF
+        return (lead == 0xF0 && s[1] < 0x90) || (lead == 0xF4 && s[1] >= 0x90) ? 0 : 4;
+    }
+    return 0;
+}
+
+std::size_t findInvalidScalar(const unsigned char* s, std::size_t n, std::size_t i) {
+    while (i < n) {
+        std::size_t length = sequenceLength(s + i, n - i);
+        if (length == 0) {
+            return i;
+        }
+        i += length;
+    }
+    return n;
+}
+
+// The code point of a sequence that has been validated
+char32_t decodeSequence(const unsigned char* s, std::size_t length) {
+    switch (length) {
+        case 1:
+            return s[0];
+        case 2:
+            return char32_t(s[0] & 0x1F) << 6 | char32_t(s[1] & 0x3F);
+        case 3:
+            return char32_t(s[0] & 0x0F) << 12 | char32_t(s[1] & 0x3F) << 6 | char32_t(s[2] & 0x3F);
+        default:
+            return char32_t(s[0] & 0x07) << 18 | char32_t(s[1] & 0x3F) << 12 | char32_t(s[2] & 0x3F) << 6
+                 | char32_t(s[3] & 0x3F);
+    }
+}
+
+// Length of a validated sequence, from its first byte
+std::size_t validLength(unsigned char lead) {
+    return lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+}
+
+char* appendUtf8(char32_t c, char* out) {
+    if (c < 0x80) {
+        *out++ = static_cast<char>(c);
+    } else if (c < 0x800) {
+        *out++ = static_cast<char>(0xC0 | c >> 6);
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | c >> 12);
+        *out++ = static_cast<char>(0x80 | (c >> 6 & 0x3F));
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | c >> 18);
+        *out++ = static_cast<char>(0x80 | (c >> 12 & 0x3F));
+        *out++ = static_cast<char>(0x80 | (c >> 6 & 0x3F));
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    return out;
+}
+
+// One code point as UTF-16 (a surrogate pair above U+FFFF) or UTF-32
+template <typename Unit>
+Unit* appendUnits(char32_t c, Unit* out) {
+    if constexpr (sizeof(Unit) == 2) {
+        if (c >= 0x10000) {
+            c -= 0x10000;
+            *out++ = static_cast<Unit>(0xD800 + (c >> 10));
+            *out++ = static_cast<Unit>(0xDC00 + (c & 0x3FF));
+            return out;
+        }
+    }
+    *out++ = static_cast<Unit>(c);
+    return out;
+}
+
+// Validated UTF-8 to UTF-16/32 units. widenAscii(s, n, out) converts the
+// leading whole blocks of ASCII and returns how many bytes that was.
+template <typename Unit, typename WidenAscii>
+std::size_t decodeValid(const unsigned char* s, std::size_t n, Unit* out, WidenAscii widenAscii) {
+    Unit* const begin = out;
+    std::size_t i = 0;
+    while (i < n) {
+        std::size_t ascii = widenAscii(s + i, n - i, out);
+        i += ascii;
+        out += ascii;
+        const std::size_t stop = std::min(n, i + kBlock);
+        while (i < stop) {
+            std::size_t length = validLength(s[i]);
+            out = appendUnits(decodeSequence(s + i, length), out);
+            i += length;
+        }
+    }
+    return static_cast<std::size_t>(out - begin);
+}
+
+// UTF-16/32 units to UTF-8, checking them as it goes. narrowAscii is the
+// reverse of widenAscii above.
+template <typename Unit, typename NarrowAscii>
+std::size_t encodeChecked(const Unit* in, std::size_t n, char* out, OnError onError, NarrowAscii narrowAscii) {
+    char* const begin = out;
+    std::size_t i = 0;
+    while (i < n) {
+        std::size_t ascii = narrowAscii(in + i, n - i, out);
+        i += ascii;
+        out += ascii;
+        const std::size_t stop = std::min(n, i + kBlock);
+        while (i < stop) {
+            char32_t c = codePointOf(in[i]);
+            std::size_t used = 1;
+            bool valid = true;
+            if constexpr (sizeof(Unit) == 2) {
+                if (isHighSurrogate(c) && i + 1 < n && isLowSurrogate(codePointOf(in[i + 1]))) {
+                    c = 0x10000 + ((c - 0xD800) << 10) + (codePointOf(in[i + 1]) - 0xDC00);
+                    used = 2;
+                } else {
+                    valid = !isHighSurrogate(c) && !isLowSurrogate(c);
+                }
+            } else {
+                valid = isScalarValue(c);
+            }
+            if (!valid) {
+                if (onError == OnError::Throw) {
+                    throw DecodeError(sizeof(Unit) == 2 ? "unpaired UTF-16 surrogate" : "invalid UTF-32 code point", i);
+                }
+                c = kReplacement;
+            }
+            out = appendUtf8(c, out);
+            i += used;
+        }
+    }
+    return static_cast<std::size_t>(out - begin);
+}
+
+std::size_t noAscii(const void*, std::size_t, const void*) {
+    return 0;
+}
+
+#if UTF_X86
+// ----- Vector code (the target attribute works as in kernels.cpp) -----
+//
+// The validation follows "Validating UTF-8 In Less Than One Instruction
+// Per Byte" (Keiser and Lemire, 2021). Looking up both nibbles of the
+// previous byte and the high nibble of the byte itself in three 16-entry
+// tables gives one bit per kind of error for every pair of bytes; AND-ing
+// the three leaves only the errors that all three agree on. The third and fourth bytes of long sequences are
+// then checked against the byte two and three positions back.
+
+constexpr char kTooShort = 1 << 0;      // A lead byte followed by a lead or ASCII byte
+constexpr char kTooLong = 1 << 1;       // ASCII followed by a continuation byte
+constexpr char kOverlong3 = 1 << 2;
+constexpr char kTooLarge = 1 << 3;      // Past U+10FFFF
+constexpr char kSurrogate = 1 << 4;
+constexpr char kOverlong2 = 1 << 5;
+constexpr char kTooLarge1000 = 1 << 6;
+constexpr char kOverlong4 = 1 << 6;
+constexpr char kTwoContinuations = static_cast<char>(1 << 7);
+constexpr char kCarry = kTooShort | kTooLong | kTwoContinuations;
+
+// Indexed by the high nibble of the first byte of a pair
+#define UTF_BYTE_1_HIGH                                                                          \
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,              \
+    kTwoContinuations, kTwoContinuations, kTwoContinuations, kTwoContinuations,                  \
+    kTooShort | kOverlong2, kTooShort, kTooShort | kOverlong3 | kSurrogate,                      \
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+// Indexed by the low nibble of the first byte
+#define UTF_BYTE_1_LOW                                                                           \
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4, kCarry | kOverlong2, kCarry, kCarry,          \
+    kCarry | kTooLarge, kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,  \
+    kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,                      \
+    kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,                      \
+    kCarry | kTooLarge | kTooLarge1000, kCarry | kTooLarge | kTooLarge1000,                      \
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate, kCarry | kTooLarge | kTooLarge1000,         \
+    kCarry | kTooLarge | kTooLarge1000
+// Indexed by the high nibble of the second byte
+#define UTF_BYTE_2_HIGH                                                                          \
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,      \
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge1000 | kOverlong4,        \
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge,                          \
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,                          \
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,                          \
+    kTooShort, kTooShort, kTooShort, kTooShort
+
+// Where the vector code found an error, the exact offset: all blocks before
+// block `block` were valid, so any byte among its last three that is not a
+// continuation byte starts a character
+std::size_t locateError(const unsigned char* s, std::size_t n, std::size_t block) {
+    std::size_t start = block >= 3 ? block - 3 : 0;
+    while (start < block && isContinuation(s[start])) {
+        start++;
+    }
+    return findInvalidScalar(s, n, start);
+}
+
+__attribute__((target("sse4.2")))
+__m128i errorsSse42(__m128i input, __m128i previous) {
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+    const __m128i byte1High = _mm_shuffle_epi8(_mm_setr_epi8(UTF_BYTE_1_HIGH),
+                                               _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    const __m128i byte1Low = _mm_shuffle_epi8(_mm_setr_epi8(UTF_BYTE_1_LOW), _mm_and_si128(prev1, nibble));
+    const __m128i byte2High = _mm_shuffle_epi8(_mm_setr_epi8(UTF_BYTE_2_HIGH),
+                                               _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    const __m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+    // A continuation byte two or three after a three- or four-byte lead is
+    // the only pair of continuations that is allowed
+    const __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, previous, 14), _mm_set1_epi8(0xE0 - 0x80));
+    const __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, previous, 13), _mm_set1_epi8(0xF0 - 0x80));
+    const __m128i mustContinue = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_xor_si128(mustContinue, special);
+}
+
+// Non-zero where a sequence is cut off by the end of the block
+__attribute__((target("sse4.2")))
+__m128i incompleteSse42(__m128i input) {
+    const __m128i maxValue = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                           static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                                           static_cast<char>(0xC0 - 1));
+    return _mm_subs_epu8(input, maxValue);
+}
+
+__attribute__((target("sse4.2")))
+std::size_t findInvalidSse42(const unsigned char* s, std::size_t n) {
+    __m128i previous = _mm_setzero_si128();
+    __m128i incomplete = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (;; i += 16) {
+        __m128i input;
+        unsigned char tail[16] = {};   // The last partial block, padded with ASCII zeros
+        if (i + 16 <= n) {
+            input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        } else {
+            std::copy(s + i, s + n, tail);
+            input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail));
+        }
+        __m128i error = incomplete;
+        if (_mm_movemask_epi8(input) != 0) {
+            error = errorsSse42(input, previous);
+            incomplete = incompleteSse42(input);
+        } else {
+            incomplete = _mm_setzero_si128();  // ASCII cannot be cut off
+        }
+        if (!_mm_testz_si128(error, error)) {
+            return locateError(s, n, i);
+        }
+        if (i + 16 > n) {   // That was the padded tail
+            return n;
+        }
+        previous = input;
+    }
+}
+
+__attribute__((target("avx2")))
+__m256i errorsAvx2(__m256i input, __m256i previous) {
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    // The 32 bytes ending one, two and three bytes earlier
+    const __m256i carried = _mm256_permute2x128_si256(previous, input, 0x21);
+    const __m256i prev1 = _mm256_alignr_epi8(input, carried, 15);
+    const __m256i byte1High = _mm256_shuffle_epi8(_mm256_setr_epi8(UTF_BYTE_1_HIGH, UTF_BYTE_1_HIGH),
+                                                  _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    const __m256i byte1Low = _mm256_shuffle_epi8(_mm256_setr_epi8(UTF_BYTE_1_LOW, UTF_BYTE_1_LOW),
+                                                 _mm256_and_si256(prev1, nibble));
+    const __m256i byte2High = _mm256_shuffle_epi8(_mm256_setr_epi8(UTF_BYTE_2_HIGH, UTF_BYTE_2_HIGH),
+                                                  _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    const __m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+    const __m256i third = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 14), _mm256_set1_epi8(0xE0 - 0x80));
+    const __m256i fourth = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 13), _mm256_set1_epi8(0xF0 - 0x80));
+    const __m256i mustContinue = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                                  _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(mustContinue, special);
+}
+
+__attribute__((target("avx2")))
+__m256i incompleteAvx2(__m256i input) {
+    const __m256i maxValue = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                              -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                              static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                                              static_cast<char>(0xC0 - 1));
+    return _mm256_subs_epu8(input, maxValue);
+}
+
+__attribute__((target("avx2")))
+std::size_t findInvalidAvx2(const unsigned char* s, std::size_t n) {
+    __m256i previous = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (;; i += 32) {
+        __m256i input;
+        unsigned char tail[32] = {};
+        if (i + 32 <= n) {
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        } else {
+            std::copy(s + i, s + n, tail);
+            input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail));
+        }
+        __m256i error = incomplete;
+        if (_mm256_movemask_epi8(input) != 0) {
+            error = errorsAvx2(input, previous);
+            incomplete = incompleteAvx2(input);
+        } else {
+            incomplete = _mm256_setzero_si256();
+        }
+        if (!_mm256_testz_si256(error, error)) {
+            return locateError(s, n, i);
+        }
+        if (i + 32 > n) {   // That was the padded tail
+            return n;
+        }
+        previous = input;
+    }
+}
+
+#undef UTF_BYTE_1_HIGH
+#undef UTF_BYTE_1_LOW
+#undef UTF_BYTE_2_HIGH
+
+// Leading blocks of ASCII bytes zero-extended to 16- or 32-bit units
+template <typename Unit>
+__attribute__((target("sse4.2")))
+std::size_t widenAsciiSse42(const unsigned char* s, std::size_t n, Unit* out) {
+    const __m128i zero = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(bytes) != 0) {
+            break;
+        }
+        const __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        const __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        auto* target = reinterpret_cast<__m128i*>(out + i);
+        if constexpr (sizeof(Unit) == 2) {
+            _mm_storeu_si128(target, low);
+            _mm_storeu_si128(target + 1, high);
+        } else {
+            _mm_storeu_si128(target, _mm_unpacklo_epi16(low, zero));
+            _mm_storeu_si128(target + 1, _mm_unpackhi_epi16(low, zero));
+            _mm_storeu_si128(target + 2, _mm_unpacklo_epi16(high, zero));
+            _mm_storeu_si128(target + 3, _mm_unpackhi_epi16(high, zero));
+        }
+    }
+    return i;
+}
+
+template <typename Unit>
+__attribute__((target("avx2")))
+std::size_t widenAsciiAvx2(const unsigned char* s, std::size_t n, Unit* out) {
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        if (_mm256_movemask_epi8(bytes) != 0) {
+            break;
+        }
+        auto* target = reinterpret_cast<__m256i*>(out + i);
+        if constexpr (sizeof(Unit) == 2) {
+            _mm256_storeu_si256(target, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+            _mm256_storeu_si256(target + 1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+        } else {
+            for (int k = 0; k < 4; k++) {
+                const __m128i eight = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(s + i + 8 * k));
+                _mm256_storeu_si256(target + k, _mm256_cvtepu8_epi32(eight));
+            }
+        }
+    }
+    return i;
+}
+
+// Leading blocks of units below 0x80 narrowed to bytes
+template <typename Unit>
+__attribute__((target("sse4.2")))
+std::size_t narrowAsciiSse42(const Unit* in, std::size_t n, char* out) {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const auto* source = reinterpret_cast<const __m128i*>(in + i);
+        __m128i packed;
+        if constexpr (sizeof(Unit) == 2) {
+            const __m128i a = _mm_loadu_si128(source);
+            const __m128i b = _mm_loadu_si128(source + 1);
+            if (!_mm_testz_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xFF80)))) {
+                break;
+            }
+            packed = _mm_packus_epi16(a, b);
+        } else {
+            const __m128i a = _mm_loadu_si128(source);
+            const __m128i b = _mm_loadu_si128(source + 1);
+            const __m128i c = _mm_loadu_si128(source + 2);
+            const __m128i d = _mm_loadu_si128(source + 3);
+            const __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+            if (!_mm_testz_si128(any, _mm_set1_epi32(static_cast<int>(0xFFFFFF80)))) {
+                break;
+            }
+            packed = _mm_packus_epi16(_mm_packus_epi32(a, b), _mm_packus_epi32(c, d));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+    return i;
+}
+
+template <typename Unit>
+__attribute__((target("avx2")))
+std::size_t narrowAsciiAvx2(const Unit* in, std::size_t n, char* out) {
+    std::size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const auto* source = reinterpret_cast<const __m256i*>(in + i);
+        __m256i packed;
+        if constexpr (sizeof(Unit) == 2) {
+            const __m256i a = _mm256_loadu_si256(source);
+            const __m256i b = _mm256_loadu_si256(source + 1);
+            if (!_mm256_testz_si256(_mm256_or_si256(a, b), _mm256_set1_epi16(static_cast<short>(0xFF80)))) {
+                break;
+            }
+            // Packing works within each 128-bit lane: a0-7 b0-7 | a8-15 b8-15
+            packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0b11'01'10'00);
+        } else {
+            const __m256i a = _mm256_loadu_si256(source);
+            const __m256i b = _mm256_loadu_si256(source + 1);
+            const __m256i c = _mm256_loadu_si256(source + 2);
+            const __m256i d = _mm256_loadu_si256(source + 3);
+            const __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+            if (!_mm256_testz_si256(any, _mm256_set1_epi32(static_cast<int>(0xFFFFFF80)))) {
+                break;
+            }
+            // a0-3 b0-3 c0-3 d0-3 | a4-7 b4-7 c4-7 d4-7, four bytes per group
+            const __m256i bytes = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+            packed = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+    return i;
+}
+#endif
+
+template <typename Unit>
+std::size_t decodeUtf8(Isa isa, const unsigned char* s, std::size_t n, Unit* out) {
+    switch (isa) {
+#if UTF_X86
+        case Isa::Avx2:
+            return decodeValid(s, n, out, widenAsciiAvx2<Unit>);
+        case Isa::Sse42:
+            return decodeValid(s, n, out, widenAsciiSse42<Unit>);
+#endif
+        default:
+            return decodeValid(s, n, out, noAscii);
+    }
+}
+
+template <typename Unit>
+std::size_t encodeUtf8(Isa isa, const Unit* in, std::size_t n, char* out, OnError onError) {
+    switch (isa) {
+#if UTF_X86
+        case Isa::Avx2:
+            return encodeChecked(in, n, out, onError, narrowAsciiAvx2<Unit>);
+        case Isa::Sse42:
+            return encodeChecked(in, n, out, onError, narrowAsciiSse42<Unit>);
+#endif
+        default:
+            return encodeChecked(in, n, out, onError, noAscii);
+    }
+}
+
+template <typename String>
+String decodeString(Isa isa, std::string_view utf8) {
+    std::size_t invalid = findInvalidUtf8(isa, utf8);
+    if (invalid != utf8.size()) {
+        throw DecodeError("invalid UTF-8", invalid);
+    }
+    // Never more units than bytes
+    String out(utf8.size(), typename String::value_type{});
+    out.resize(decodeUtf8(isa, reinterpret_cast<const unsigned char*>(utf8.data()), utf8.size(), out.data()));
+    return out;
+}
+
+template <typename Unit>
+std::string encodeString(Isa isa, std::basic_string_view<Unit> text) {
+    requireSupported(isa);
+    // At most three bytes per UTF-16 unit and four per code point
+    std::string out(text.size() * (sizeof(Unit) == 2 ? 3 : 4), '\0');
+    out.resize(encodeUtf8(isa, text.data(), text.size(), out.data(), OnError::Throw));
+    return out;
+}
+
+template <typename Unit>
+std::ostream& print(std::ostream& os, std::basic_string_view<Unit> text) {
+    constexpr std::size_t kChunk = 256;
+    char buffer[kChunk * 4];
+    while (!text.empty()) {
+        std::size_t count = std::min(kChunk, text.size());
+        // Keep a surrogate pair in one chunk
+        if (sizeof(Unit) == 2 && count < text.size() && isHighSurrogate(codePointOf(text[count - 1]))) {
+            count--;
+        }
+        std::size_t bytes = encodeUtf8(kernels::bestIsa(), text.data(), count, buffer, OnError::Replace);
+        os.write(buffer, static_cast<std::streamsize>(bytes));
+        text.remove_prefix(count);
+    }
+    return os;
+}
+
+}
+
+std::size_t findInvalidUtf8(std::string_view text) {
+    return findInvalidUtf8(kernels::bestIsa(), text);
+}
+
+std::size_t findInvalidUtf8(Isa isa, std::string_view text) {
+    requireSupported(isa);
+    const auto* s = reinterpret_cast<const unsigned char*>(text.data());
+    switch (isa) {
+#if UTF_X86
+        case Isa::Avx2:
+            return findInvalidAvx2(s, text.size());
+        case Isa::Sse42:
+            return findInvalidSse42(s, text.size());
+#endif
+        default:
+            return findInvalidScalar(s, text.size(), 0);
+    }
+}
+
+std::u16string toUtf16(std::string_view utf8) {
+    return toUtf16(kernels::bestIsa(), utf8);
+}
+
+std::u16string toUtf16(Isa isa, std::string_view utf8) {
+    return decodeString<std::u16string>(isa, utf8);
+}
+
+std::u32string toUtf32(std::string_view utf8) {
+    return toUtf32(kernels::bestIsa(), utf8);
+}
+
+std::u32string toUtf32(Isa isa, std::string_view utf8) {
+    return decodeString<std::u32string>(isa, utf8);
+}
+
+std::wstring toWide(std::string_view utf8) {
+    return decodeString<std::wstring>(kernels::bestIsa(), utf8);
+}
+
+std::string toUtf8(std::u16string_view text) {
+    return toUtf8(kernels::bestIsa(), text);
+}
+
+std::string toUtf8(Isa isa, std::u16string_view text) {
+    return encodeString(isa, text);
+}
+
+std::string toUtf8(std::u32string_view text) {
+    return toUtf8(kernels::bestIsa(), text);
+}
+
+std::string toUtf8(Isa isa, std::u32string_view text) {
+    return encodeString(isa, text);
+}
+
+std::string toUtf8(std::wstring_view text) {
+    return encodeString(kernels::bestIsa(), text);
+}
+
+std::ostream& operator<<(std::ostream& os, Utf8Printer<char16_t> printer) {
+    return print(os, printer.text);
+}
+
+std::ostream& operator<<(std::ostream& os, Utf8Printer<char32_t> printer) {
+    return print(os, printer.text);
+}
+
+std::ostream& operator<<(std::ostream& os, Utf8Printer<wchar_t> printer) {
+    return print(os, printer.text);
+}
+
+}
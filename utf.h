@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "kernels.h"
+
+/*
+ * Conversions between UTF-8 (std::string), UTF-16 (std::u16string) and
+ * UTF-32 (std::u32string), plus std::wstring, which is UTF-32 on Linux and
+ * macOS and UTF-16 on Windows. Similar to Encoding.UTF8.GetString() and
+ * GetBytes() in C#, or TextDecoder/TextEncoder in JavaScript, and a
+ * replacement for std::wstring_convert and <codecvt>, which are deprecated
+ * since C++17 (and slow).
+ *
+ * UTF-8 is validated 32 bytes at a time with AVX2 (16 with SSE4.2): every
+ * pair of neighbouring bytes is classified with table lookups, so a
+ * multilingual text costs about as much as an ASCII one. The conversions
+ * copy runs of ASCII with vector instructions and decode everything else
+ * one character at a time. As in kernels.h, the best instruction set is
+ * chosen at runtime; NEON uses the scalar code.
+ *
+ * Invalid input (a truncated or overlong sequence, an unpaired surrogate,
+ * a code point past U+10FFFF) throws DecodeError, except when printing
+ * with asUtf8(), which shows U+FFFD instead.
+ */
+namespace utf {
+
+class DecodeError : public std::runtime_error {
+  public:
+      DecodeError(const std::string& what, std::size_t offset)
+          : std::runtime_error(what + " at offset " + std::to_string(offset)), offset_(offset) {}
+
+      // Where the invalid sequence starts, in code units of the input
+      std::size_t offset() const { return offset_; }
+
+  private:
+      std::size_t offset_;
+};
+
+// ----- Validation -----
+// Offset of the first byte of the first invalid sequence, or text.size()
+// if it is all valid UTF-8
+std::size_t findInvalidUtf8(std::string_view text);
+std::size_t findInvalidUtf8(kernels::Isa isa, std::string_view text);
+inline bool isValidUtf8(std::string_view text) { return findInvalidUtf8(text) == text.size(); }
+
+// ----- Conversions (throw DecodeError) -----
+std::u16string toUtf16(std::string_view utf8);
+std::u16string toUtf16(kernels::Isa isa, std::string_view utf8);
+std::u32string toUtf32(std::string_view utf8);
+std::u32string toUtf32(kernels::Isa isa, std::string_view utf8);
+std::wstring toWide(std::string_view utf8);
+
+std::string toUtf8(std::u16string_view text);
+std::string toUtf8(kernels::Isa isa, std::u16string_view text);
+std::string toUtf8(std::u32string_view text);
+std::string toUtf8(kernels::Isa isa, std::u32string_view text);
+std::string toUtf8(std::wstring_view text);
+
+// ----- Printing -----
+// `out << utf::asUtf8(wideText)` writes the text as UTF-8 in small pieces,
+// without building a std::string first (std::ostream cannot print a
+// std::wstring at all)
+template <typename Unit>
+struct Utf8Printer {
+    std::basic_string_view<Unit> text;
+};
+
+constexpr Utf8Printer<char16_t> asUtf8(std::u16string_view text) { return {text}; }
+constexpr Utf8Printer<char32_t> asUtf8(std::u32string_view text) { return {text}; }
+constexpr Utf8Printer<wchar_t> asUtf8(std::wstring_view text) { return {text}; }
+
+std::ostream& operator<<(std::ostream& os, Utf8Printer<char16_t> printer);
+std::ostream& operator<<(std::ostream& os, Utf8Printer<char32_t> printer);
+std::ostream& operator<<(std::ostream& os, Utf8Printer<wchar_t> printer);
+
+}